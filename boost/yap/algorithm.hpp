@@ -44,14 +44,14 @@ namespace boost { namespace yap {
         template <typename Expr, bool MutableRvalueRef>
         struct deref_impl
         {
-            decltype(auto) operator() (Expr && expr)
+            constexpr decltype(auto) operator() (Expr && expr)
             { return std::move(*expr.elements[hana::llong_c<0>]); }
         };
 
         template <typename Expr>
         struct deref_impl<Expr, false>
         {
-            decltype(auto) operator() (Expr && expr)
+            constexpr decltype(auto) operator() (Expr && expr)
             { return *expr.elements[hana::llong_c<0>]; }
         };
 
@@ -62,7 +62,7 @@ namespace boost { namespace yap {
     /** "Dereferences" a reference-expression, forwarding its referent to the
         caller. */
     template <typename Expr>
-    decltype(auto) deref (Expr && expr)
+    constexpr decltype(auto) deref (Expr && expr)
     {
         static_assert(
             is_expr<Expr>::value,
@@ -98,7 +98,7 @@ namespace boost { namespace yap {
 #ifdef BOOST_NO_CONSTEXPR_IF
 
         template <bool ValueOfTerminalsOnly, typename T>
-        decltype(auto) value_impl (T && x);
+        constexpr decltype(auto) value_impl (T && x);
 
         template <typename T, bool IsExprRef, bool ValueOfTerminalsOnly, bool TakeValue, bool IsLvalueRef>
         struct value_expr_impl;
@@ -106,35 +106,35 @@ namespace boost { namespace yap {
         template <typename T, bool ValueOfTerminalsOnly, bool TakeValue, bool IsLvalueRef>
         struct value_expr_impl<T, true, ValueOfTerminalsOnly, TakeValue, IsLvalueRef>
         {
-            decltype(auto) operator() (T && x)
+            constexpr decltype(auto) operator() (T && x)
             { return value_impl<ValueOfTerminalsOnly>(::boost::yap::deref(static_cast<T &&>(x))); }
         };
 
         template <typename T, bool ValueOfTerminalsOnly>
         struct value_expr_impl<T, false, ValueOfTerminalsOnly, true, true>
         {
-            decltype(auto) operator() (T && x)
+            constexpr decltype(auto) operator() (T && x)
             { return x.elements[hana::llong_c<0>]; }
         };
 
         template <typename T, bool ValueOfTerminalsOnly>
         struct value_expr_impl<T, false, ValueOfTerminalsOnly, true, false>
         {
-            decltype(auto) operator() (T && x)
+            constexpr decltype(auto) operator() (T && x)
             { return std::move(x.elements[hana::llong_c<0>]); }
         };
 
         template <typename T, bool ValueOfTerminalsOnly, bool IsLvalueRef>
         struct value_expr_impl<T, false, ValueOfTerminalsOnly, false, IsLvalueRef>
         {
-            decltype(auto) operator() (T && x)
+            constexpr decltype(auto) operator() (T && x)
             { return static_cast<T &&>(x); }
         };
 
         template <typename T, bool IsExpr, bool ValueOfTerminalsOnly>
         struct value_impl_t
         {
-            decltype(auto) operator() (T && x)
+            constexpr decltype(auto) operator() (T && x)
             {
                 constexpr expr_kind kind = detail::remove_cv_ref_t<T>::kind;
                 constexpr detail::expr_arity arity = detail::arity_of<kind>();
@@ -152,12 +152,12 @@ namespace boost { namespace yap {
         template <typename T, bool ValueOfTerminalsOnly>
         struct value_impl_t<T, false, ValueOfTerminalsOnly>
         {
-            decltype(auto) operator() (T && x)
+            constexpr decltype(auto) operator() (T && x)
             { return static_cast<T &&>(x); }
         };
 
         template <bool ValueOfTerminalsOnly, typename T>
-        decltype(auto) value_impl (T && x)
+        constexpr decltype(auto) value_impl (T && x)
         {
             return detail::value_impl_t<T, is_expr<T>::value, ValueOfTerminalsOnly>{}(
                 static_cast<T &&>(x)
@@ -167,7 +167,7 @@ namespace boost { namespace yap {
 #else
 
         template <bool ValueOfTerminalsOnly, typename T>
-        decltype(auto) value_impl (T && x)
+        constexpr decltype(auto) value_impl (T && x)
         {
             if constexpr (is_expr<T>::value) {
                 using namespace hana::literals;
@@ -213,13 +213,13 @@ namespace boost { namespace yap {
 
         - Otherwise, \a x is forwarded to the caller. */
     template <typename T>
-    decltype(auto) value (T && x)
+    constexpr decltype(auto) value (T && x)
     { return detail::value_impl<false>(static_cast<T &&>(x)); }
 
 #ifdef BOOST_NO_CONSTEXPR_IF
 
     template <long long I, typename Expr>
-    decltype(auto) get (Expr && expr, hana::llong<I> i);
+    constexpr decltype(auto) get (Expr && expr, hana::llong<I> i);
 
     namespace detail {
 
@@ -229,21 +229,21 @@ namespace boost { namespace yap {
         template <long long I, typename Expr, bool IsLvalueRef>
         struct get_impl<I, Expr, true, IsLvalueRef>
         {
-            decltype(auto) operator() (Expr && expr, hana::llong<I> i)
+            constexpr decltype(auto) operator() (Expr && expr, hana::llong<I> i)
             { return ::boost::yap::get(::boost::yap::deref(static_cast<Expr &&>(expr)), i); }
         };
 
         template <long long I, typename Expr>
         struct get_impl<I, Expr, false, true>
         {
-            decltype(auto) operator() (Expr && expr, hana::llong<I> i)
+            constexpr decltype(auto) operator() (Expr && expr, hana::llong<I> i)
             { return expr.elements[i]; }
         };
 
         template <long long I, typename Expr>
         struct get_impl<I, Expr, false, false>
         {
-            decltype(auto) operator() (Expr && expr, hana::llong<I> i)
+            constexpr decltype(auto) operator() (Expr && expr, hana::llong<I> i)
             { return std::move(expr.elements[i]); }
         };
 
@@ -258,7 +258,7 @@ namespace boost { namespace yap {
         \note <code>get()</code> is only valid if \a Expr is an expression.
     */
     template <long long I, typename Expr>
-    decltype(auto) get (Expr && expr, hana::llong<I> i)
+    constexpr decltype(auto) get (Expr && expr, hana::llong<I> i)
     {
         static_assert(
             is_expr<Expr>::value,
@@ -297,7 +297,7 @@ namespace boost { namespace yap {
 
     /** Returns <code>get(expr, boost::hana::llong_c<I>)</code>. */
     template <long long I, typename Expr>
-    decltype(auto) get_c (Expr && expr)
+    constexpr decltype(auto) get_c (Expr && expr)
     { return ::boost::yap::get(static_cast<Expr &&>(expr), hana::llong_c<I>); }
 
     /** Returns the left operand in a binary operator expression.
@@ -308,7 +308,7 @@ namespace boost { namespace yap {
         operator expression.
     */
     template <typename Expr>
-    decltype(auto) left (Expr && expr)
+    constexpr decltype(auto) left (Expr && expr)
     {
         using namespace hana::literals;
         return ::boost::yap::get(static_cast<Expr &&>(expr), 0_c);
@@ -328,7 +328,7 @@ namespace boost { namespace yap {
         operator expression.
     */
     template <typename Expr>
-    decltype(auto) right (Expr && expr)
+    constexpr decltype(auto) right (Expr && expr)
     {
         using namespace hana::literals;
         return ::boost::yap::get(static_cast<Expr &&>(expr), 1_c);
@@ -348,7 +348,7 @@ namespace boost { namespace yap {
         <code>expr_kind::if_else</code> expression.
     */
     template <typename Expr>
-    decltype(auto) cond (Expr && expr)
+    constexpr decltype(auto) cond (Expr && expr)
     {
         using namespace hana::literals;
         return ::boost::yap::get(static_cast<Expr &&>(expr), 0_c);
@@ -367,7 +367,7 @@ namespace boost { namespace yap {
         <code>expr_kind::if_else</code> expression.
     */
     template <typename Expr>
-    decltype(auto) then (Expr && expr)
+    constexpr decltype(auto) then (Expr && expr)
     {
         using namespace hana::literals;
         return ::boost::yap::get(static_cast<Expr &&>(expr), 1_c);
@@ -386,7 +386,7 @@ namespace boost { namespace yap {
         <code>expr_kind::if_else</code> expression.
     */
     template <typename Expr>
-    decltype(auto) else_ (Expr && expr)
+    constexpr decltype(auto) else_ (Expr && expr)
     {
         using namespace hana::literals;
         return ::boost::yap::get(static_cast<Expr &&>(expr), 2_c);
@@ -405,7 +405,7 @@ namespace boost { namespace yap {
         <code>expr_kind::call</code> expression.
     */
     template <typename Expr>
-    decltype(auto) callable (Expr && expr)
+    constexpr decltype(auto) callable (Expr && expr)
     {
         return ::boost::yap::get(static_cast<Expr &&>(expr), hana::llong_c<0>);
         constexpr expr_kind kind = detail::remove_cv_ref_t<Expr>::kind;
@@ -424,7 +424,7 @@ namespace boost { namespace yap {
         <code>expr_kind::call</code> expression.
     */
     template <long long I, typename Expr>
-    decltype(auto) argument (Expr && expr, hana::llong<I> i)
+    constexpr decltype(auto) argument (Expr && expr, hana::llong<I> i)
     {
         return ::boost::yap::get(static_cast<Expr &&>(expr), hana::llong_c<I + 1>);
         constexpr expr_kind kind = detail::remove_cv_ref_t<Expr>::kind;
@@ -455,7 +455,7 @@ namespace boost { namespace yap {
         parameters passed is appropriate for \a Kind.
     */
     template <template <expr_kind, class> class ExprTemplate, expr_kind Kind, typename ...T>
-    auto make_expression (T && ... t)
+    constexpr auto make_expression (T && ... t)
     {
         constexpr detail::expr_arity arity = detail::arity_of<Kind>();
         static_assert(
@@ -481,7 +481,7 @@ namespace boost { namespace yap {
         expression.
     */
     template <template <expr_kind, class> class ExprTemplate, typename T>
-    auto make_terminal (T && t)
+    constexpr auto make_terminal (T && t)
     {
         static_assert(
             !is_expr<T>::value,
@@ -499,14 +499,14 @@ namespace boost { namespace yap {
         template <template <expr_kind, class> class ExprTemplate, typename T, bool IsExpr>
         struct as_expr_impl
         {
-            decltype(auto) operator() (T && t)
+            constexpr decltype(auto) operator() (T && t)
             { return static_cast<T &&>(t); }
         };
 
         template <template <expr_kind, class> class ExprTemplate, typename T>
         struct as_expr_impl<ExprTemplate, T, false>
         {
-            decltype(auto) operator() (T && t)
+            constexpr decltype(auto) operator() (T && t)
             { return make_terminal<ExprTemplate>(static_cast<T &&>(t)); }
         };
 
@@ -521,7 +521,7 @@ namespace boost { namespace yap {
         - Otherwise, \a t is wrapped in a terminal expression.
     */
     template <template <expr_kind, class> class ExprTemplate, typename T>
-    decltype(auto) as_expr (T && t)
+    constexpr decltype(auto) as_expr (T && t)
     {
 #ifdef BOOST_NO_CONSTEXPR_IF
         return detail::as_expr_impl<ExprTemplate, T, is_expr<T>::value>{}(
@@ -544,7 +544,7 @@ namespace boost { namespace yap {
     struct expression_function
     {
         template <typename ...U>
-        decltype(auto) operator() (U && ... u)
+        constexpr decltype(auto) operator() (U && ... u)
         { return ::boost::yap::evaluate(expr, static_cast<U &&>(u)...); }
 
         Expr expr;
@@ -571,7 +571,7 @@ namespace boost { namespace yap {
         Expr is an expression.
     */
     template <typename Expr>
-    auto make_expression_function (Expr && expr)
+    constexpr auto make_expression_function (Expr && expr)
     {
         static_assert(
             is_expr<Expr>::value,
@@ -602,7 +602,7 @@ namespace boost { namespace yap {
         <code>max_p</code> is the maximum placeholder index in \a expr.
     */
     template <typename Expr, typename ...T>
-    decltype(auto) evaluate (Expr && expr, T && ... t)
+    constexpr decltype(auto) evaluate (Expr && expr, T && ... t)
     {
         static_assert(
             is_expr<Expr>::value,
@@ -627,7 +627,7 @@ namespace boost { namespace yap {
         <code>max_p</code> is the maximum placeholder index in \a expr.
     */
     template <typename R, typename Expr, typename ...T>
-    decltype(auto) evaluate_as (Expr && expr, T && ... t)
+    constexpr decltype(auto) evaluate_as (Expr && expr, T && ... t)
     {
         static_assert(
             is_expr<Expr>::value,
@@ -643,7 +643,7 @@ namespace boost { namespace yap {
         template <typename Expr, typename Transform, bool IsExpr>
         struct transform_impl
         {
-            decltype(auto) operator() (Expr && expr, Transform && transform)
+            constexpr decltype(auto) operator() (Expr && expr, Transform && transform)
             {
                 constexpr expr_kind kind = detail::remove_cv_ref_t<Expr>::kind;
                 return detail::default_transform_expression_tag<Expr, Transform, detail::arity_of<kind>()>{}(
@@ -656,7 +656,7 @@ namespace boost { namespace yap {
         template <typename Expr, typename Transform>
         struct transform_impl<Expr, Transform, false>
         {
-            decltype(auto) operator() (Expr && expr, Transform && transform)
+            constexpr decltype(auto) operator() (Expr && expr, Transform && transform)
             { return static_cast<Expr &&>(expr); }
         };
 
@@ -673,7 +673,7 @@ namespace boost { namespace yap {
         combination of these.
     */
     template <typename Expr, typename Transform>
-    decltype(auto) transform (Expr && expr, Transform && transform)
+    constexpr decltype(auto) transform (Expr && expr, Transform && transform)
     {
 #ifdef BOOST_NO_CONSTEXPR_IF
         return detail::transform_impl<Expr, Transform, is_expr<Expr>::value>{}(
@@ -693,6 +693,64 @@ namespace boost { namespace yap {
 #endif
     }
 
+    /** Returns the result of folding \a fn over the nodes of \a expr,
+        starting with \a init.
+
+        The nodes are visited in preorder: each node before its operands,
+        and operands from left to right.  Reference expressions are
+        transparent; <code>fn</code> sees their referents instead.  For each
+        node <code>n</code> for which <code>fn(state, n)</code> is
+        well-formed, the state becomes the result of that call; all other
+        nodes leave the state unchanged.  The state may change type from one
+        call to the next.
+
+        The traversal is unrolled at compile time, and no expression is
+        built.
+    */
+    template <typename Expr, typename State, typename Fn>
+    constexpr auto fold (Expr const & expr, State init, Fn && fn)
+    {
+        static_assert(
+            is_expr<Expr>::value,
+            "fold() is only defined for expressions."
+        );
+        return detail::fold_impl<Expr::kind>{}(fn, std::move(init), expr);
+    }
+
+    /** Returns true iff <code>pred(n)</code> is true for some node
+        <code>n</code> of \a expr.
+
+        Nodes are visited as in <code>fold()</code>, and nodes for which
+        <code>pred(n)</code> is ill-formed are skipped.  The traversal stops
+        at the first node for which <code>pred(n)</code> is true.
+    */
+    template <typename Expr, typename Pred>
+    constexpr bool any_of (Expr const & expr, Pred && pred)
+    {
+        static_assert(
+            is_expr<Expr>::value,
+            "any_of() is only defined for expressions."
+        );
+        return detail::find_node<true, Expr::kind>{}(pred, expr);
+    }
+
+    /** Returns true iff <code>pred(n)</code> is true for every node
+        <code>n</code> of \a expr.
+
+        Nodes are visited as in <code>fold()</code>, and nodes for which
+        <code>pred(n)</code> is ill-formed are skipped.  The traversal stops
+        at the first node for which <code>pred(n)</code> is false.
+    */
+    template <typename Expr, typename Pred>
+    constexpr bool all_of (Expr const & expr, Pred && pred)
+    {
+        static_assert(
+            is_expr<Expr>::value,
+            "all_of() is only defined for expressions."
+        );
+        return detail::find_node<false, Expr::kind>{}(pred, expr);
+    }
+
     /** Returns the <code>char const *</code> string for the spelling of the
         C++ operator associated with \a kind. */
     inline char const * op_string (expr_kind kind)
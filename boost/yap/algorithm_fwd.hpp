@@ -75,6 +75,11 @@ namespace boost { namespace yap {
     template <long long I>
     struct placeholder : hana::llong<I> {};
 
+    /** The type of value held by a lazy terminal.  Defined in
+        <code>lazy_terminal.hpp</code>. */
+    template <typename F>
+    struct lazy_value;
+
 #ifdef BOOST_YAP_DOXYGEN
 
     /** A metafunction that evaluates to std::true_type if \a Expr is an
@@ -133,19 +138,19 @@ namespace boost { namespace yap {
 #ifndef BOOST_YAP_DOXYGEN
 
     template <typename Expr, typename ...T>
-    decltype(auto) evaluate (Expr && expr, T && ... t);
+    constexpr decltype(auto) evaluate (Expr && expr, T && ... t);
 
     template <typename R, typename Expr, typename ...T>
-    decltype(auto) evaluate_as (Expr && expr, T && ... t);
+    constexpr decltype(auto) evaluate_as (Expr && expr, T && ... t);
 
     template <typename Expr, typename Transform>
-    decltype(auto) transform (Expr && expr, Transform && transform);
+    constexpr decltype(auto) transform (Expr && expr, Transform && transform);
 
     template <typename T>
-    decltype(auto) deref (T && x);
+    constexpr decltype(auto) deref (T && x);
 
     template <typename Expr>
-    decltype(auto) value (Expr && expr);
+    constexpr decltype(auto) value (Expr && expr);
 
 #endif // BOOST_YAP_DOXYGEN
 
@@ -8,6 +8,7 @@
 
 #include <memory>
 #include <type_traits>
+#include <utility>
 
 
 namespace boost { namespace yap {
@@ -134,18 +135,23 @@ namespace boost { namespace yap {
         struct make_operand
         {
             template <typename U>
-            auto operator() (U && u)
+            constexpr auto operator() (U && u)
             { return T{static_cast<U &&>(u)}; }
+
+            // An rvalue that already has the operand type is passed through,
+            // so that it is moved only once, into the tuple that holds it.
+            constexpr T && operator() (T && t)
+            { return static_cast<T &&>(t); }
         };
 
         template <template <expr_kind, class> class ExprTemplate, typename Tuple>
         struct make_operand<ExprTemplate<expr_kind::expr_ref, Tuple>>
         {
-            auto operator() (ExprTemplate<expr_kind::expr_ref, Tuple> expr)
+            constexpr auto operator() (ExprTemplate<expr_kind::expr_ref, Tuple> expr)
             { return expr; }
 
             template <typename U>
-            auto operator() (U && u)
+            constexpr auto operator() (U && u)
             { return ExprTemplate<expr_kind::expr_ref, Tuple>{Tuple{std::addressof(u)}}; }
         };
 
@@ -581,6 +587,235 @@ namespace boost { namespace yap {
 
 #undef CASE
 
+
+        // terminal_element
+
+        template <typename Tuple>
+        struct terminal_element;
+
+        template <typename T>
+        struct terminal_element<hana::tuple<T>>
+        { using type = T; };
+
+        template <typename Expr>
+        using terminal_element_t =
+            typename terminal_element<remove_cv_ref_t<decltype(std::declval<Expr>().elements)>>::type;
+
+
+        // strip_expr_ref
+
+        template <typename Expr, bool IsExprRef = remove_cv_ref_t<Expr>::kind == expr_kind::expr_ref>
+        struct strip_expr_ref
+        { using type = remove_cv_ref_t<Expr>; };
+
+        template <typename Expr>
+        struct strip_expr_ref<Expr, true>
+        {
+            using type = typename strip_expr_ref<
+                std::remove_pointer_t<terminal_element_t<Expr>>
+            >::type;
+        };
+
+        template <typename Expr>
+        using strip_expr_ref_t = typename strip_expr_ref<Expr>::type;
+
+
+        // all_true
+
+        template <bool ...B>
+        struct bool_pack;
+
+        template <bool ...B>
+        using all_true = std::is_same<bool_pack<true, B...>, bool_pack<B..., true>>;
+
+        template <bool ...B>
+        using any_true = std::integral_constant<bool, !all_true<!B...>::value>;
+
+
+        // elementwise_all
+
+        template <template <class, class> class Pred, typename Tuple1, typename Tuple2>
+        struct elementwise_all : std::false_type {};
+
+        template <template <class, class> class Pred, typename ...T, typename ...U>
+        struct elementwise_all<Pred, hana::tuple<T...>, hana::tuple<U...>>
+        {
+            template <bool SameSize, typename = void>
+            struct impl : std::false_type {};
+
+            template <typename Dummy>
+            struct impl<true, Dummy> : all_true<Pred<T, U>::value...> {};
+
+            static bool const value = impl<sizeof...(T) == sizeof...(U)>::value;
+        };
+
+
+        // fold
+
+        template <typename Fn, typename State, typename Expr, typename = void_t<>>
+        struct folds_over : std::false_type {};
+
+        template <typename Fn, typename State, typename Expr>
+        struct folds_over<
+            Fn,
+            State,
+            Expr,
+            void_t<decltype(std::declval<Fn &>()(std::declval<State>(), std::declval<Expr const &>()))>
+        > : std::true_type {};
+
+        template <bool FoldsOver>
+        struct fold_node
+        {
+            template <typename Fn, typename State, typename Expr>
+            constexpr State operator() (Fn &, State state, Expr const &)
+            { return state; }
+        };
+
+        template <>
+        struct fold_node<true>
+        {
+            template <typename Fn, typename State, typename Expr>
+            constexpr auto operator() (Fn & fn, State state, Expr const & expr)
+            { return fn(std::move(state), expr); }
+        };
+
+        template <expr_kind Kind>
+        struct fold_impl
+        {
+            template <typename Fn, typename State, typename Expr>
+            constexpr auto operator() (Fn & fn, State state, Expr const & expr)
+            {
+                auto node_state = fold_node<folds_over<Fn, State, Expr>::value>{}(
+                    fn,
+                    std::move(state),
+                    expr
+                );
+                constexpr long long size = decltype(hana::size(expr.elements))::value;
+                return fold_elements(
+                    fn,
+                    std::move(node_state),
+                    expr,
+                    hana::llong_c<0>,
+                    hana::llong_c<size>
+                );
+            }
+
+            template <typename Fn, typename State, typename Expr, long long N>
+            static constexpr State fold_elements (Fn &, State state, Expr const &, hana::llong<N>, hana::llong<N>)
+            { return state; }
+
+            template <typename Fn, typename State, typename Expr, long long I, long long N>
+            static constexpr auto fold_elements (Fn & fn, State state, Expr const & expr, hana::llong<I> i, hana::llong<N> n)
+            {
+                using element_type = remove_cv_ref_t<decltype(expr.elements[i])>;
+                return fold_elements(
+                    fn,
+                    fold_impl<element_type::kind>{}(fn, std::move(state), expr.elements[i]),
+                    expr,
+                    hana::llong_c<I + 1>,
+                    n
+                );
+            }
+        };
+
+        template <>
+        struct fold_impl<expr_kind::expr_ref>
+        {
+            template <typename Fn, typename State, typename Expr>
+            constexpr auto operator() (Fn & fn, State state, Expr const & expr)
+            {
+                decltype(auto) referent = ::boost::yap::deref(expr);
+                using referent_type = remove_cv_ref_t<decltype(referent)>;
+                return fold_impl<referent_type::kind>{}(fn, std::move(state), referent);
+            }
+        };
+
+        template <>
+        struct fold_impl<expr_kind::terminal>
+        {
+            template <typename Fn, typename State, typename Expr>
+            constexpr auto operator() (Fn & fn, State state, Expr const & expr)
+            { return fold_node<folds_over<Fn, State, Expr>::value>{}(fn, std::move(state), expr); }
+        };
+
+
+        // any_of, all_of
+
+        template <typename Pred, typename Expr, typename = void_t<>>
+        struct tests : std::false_type {};
+
+        template <typename Pred, typename Expr>
+        struct tests<
+            Pred,
+            Expr,
+            void_t<decltype(std::declval<Pred &>()(std::declval<Expr const &>()))>
+        > : std::true_type {};
+
+        template <bool Untested, bool Tests>
+        struct test_node
+        {
+            template <typename Pred, typename Expr>
+            constexpr bool operator() (Pred &, Expr const &)
+            { return Untested; }
+        };
+
+        template <bool Untested>
+        struct test_node<Untested, true>
+        {
+            template <typename Pred, typename Expr>
+            constexpr bool operator() (Pred & pred, Expr const & expr)
+            { return static_cast<bool>(pred(expr)); }
+        };
+
+        // Visits nodes until one tests Decisive, in which case the result is
+        // Decisive; any_of() is find_node<true>, and all_of() is
+        // find_node<false>.
+        template <bool Decisive, expr_kind Kind>
+        struct find_node
+        {
+            template <typename Pred, typename Expr>
+            constexpr bool operator() (Pred & pred, Expr const & expr)
+            {
+                if (test_node<!Decisive, tests<Pred, Expr>::value>{}(pred, expr) == Decisive)
+                    return Decisive;
+                constexpr long long size = decltype(hana::size(expr.elements))::value;
+                return find_element(pred, expr, hana::llong_c<0>, hana::llong_c<size>);
+            }
+
+            template <typename Pred, typename Expr, long long N>
+            static constexpr bool find_element (Pred &, Expr const &, hana::llong<N>, hana::llong<N>)
+            { return !Decisive; }
+
+            template <typename Pred, typename Expr, long long I, long long N>
+            static constexpr bool find_element (Pred & pred, Expr const & expr, hana::llong<I> i, hana::llong<N> n)
+            {
+                using element_type = remove_cv_ref_t<decltype(expr.elements[i])>;
+                if (find_node<Decisive, element_type::kind>{}(pred, expr.elements[i]) == Decisive)
+                    return Decisive;
+                return find_element(pred, expr, hana::llong_c<I + 1>, n);
+            }
+        };
+
+        template <bool Decisive>
+        struct find_node<Decisive, expr_kind::expr_ref>
+        {
+            template <typename Pred, typename Expr>
+            constexpr bool operator() (Pred & pred, Expr const & expr)
+            {
+                decltype(auto) referent = ::boost::yap::deref(expr);
+                using referent_type = remove_cv_ref_t<decltype(referent)>;
+                return find_node<Decisive, referent_type::kind>{}(pred, referent);
+            }
+        };
+
+        template <bool Decisive>
+        struct find_node<Decisive, expr_kind::terminal>
+        {
+            template <typename Pred, typename Expr>
+            constexpr bool operator() (Pred & pred, Expr const & expr)
+            { return test_node<!Decisive, tests<Pred, Expr>::value>{}(pred, expr); }
+        };
+
     }
 
 } }
@@ -17,7 +17,7 @@ namespace boost { namespace yap {
         inline nonexistent_transform transform_expression (...) { return {}; }
 
         template <typename I, typename T>
-        decltype(auto) eval_placeholder (I, T && arg)
+        constexpr decltype(auto) eval_placeholder (I, T && arg)
         {
             static_assert(
                 I::value == 1,
@@ -30,17 +30,17 @@ namespace boost { namespace yap {
 #ifdef BOOST_NO_CONSTEXPR_IF
 
         template <typename T, typename ...Ts>
-        decltype(auto) eval_placeholder (hana::llong<1>, T && arg, Ts && ... args)
+        constexpr decltype(auto) eval_placeholder (hana::llong<1>, T && arg, Ts && ... args)
         { return static_cast<T &&>(arg); }
 
         template <typename I, typename T, typename ...Ts>
-        decltype(auto) eval_placeholder (I, T && arg, Ts && ... args)
+        constexpr decltype(auto) eval_placeholder (I, T && arg, Ts && ... args)
         { return eval_placeholder(hana::llong<I::value - 1>{}, static_cast<Ts &&>(args)...); }
 
 #else
 
         template <typename I, typename T, typename ...Ts>
-        decltype(auto) eval_placeholder (I, T && arg, Ts && ... args)
+        constexpr decltype(auto) eval_placeholder (I, T && arg, Ts && ... args)
         {
             if constexpr (I::value == 1) {
                 return static_cast<T &&>(arg);
@@ -52,17 +52,30 @@ namespace boost { namespace yap {
 #endif
 
         template <long long I, typename ...T>
-        decltype(auto) eval_terminal (placeholder<I>, T && ... args)
+        constexpr decltype(auto) eval_terminal (placeholder<I>, T && ... args)
         { return eval_placeholder(hana::llong_c<I>, static_cast<T &&>(args)...); }
 
         template <typename T, typename ...Ts>
-        decltype(auto) eval_terminal (T && value, Ts && ... args)
+        constexpr decltype(auto) eval_terminal (T && value, Ts && ... args)
         { return static_cast<T &&>(value); }
 
+        template <typename F, typename ...Ts>
+        decltype(auto) eval_terminal (lazy_value<F> & value, Ts && ... args)
+        { return value.get(); }
+
+        template <typename F, typename ...Ts>
+        decltype(auto) eval_terminal (lazy_value<F> const & value, Ts && ... args)
+        { return value.get(); }
+
+        // The cached result may not outlive an rvalue, so it is copied out.
+        template <typename F, typename ...Ts>
+        auto eval_terminal (lazy_value<F> && value, Ts && ... args)
+        { return typename lazy_value<F>::result_type(value.get()); }
+
 #ifdef BOOST_NO_CONSTEXPR_IF
 
         template <typename Expr, typename ...T>
-        decltype(auto) default_eval_expr (Expr && expr, T && ... args);
+        constexpr decltype(auto) default_eval_expr (Expr && expr, T && ... args);
 
         template <expr_kind Kind>
         struct default_eval_expr_impl;
@@ -71,7 +84,7 @@ namespace boost { namespace yap {
         struct default_eval_expr_impl<expr_kind::expr_ref>
         {
             template <typename Expr, typename ...T>
-            decltype(auto) operator() (Expr && expr, T && ... args)
+            constexpr decltype(auto) operator() (Expr && expr, T && ... args)
             { return default_eval_expr(::boost::yap::deref(static_cast<Expr &&>(expr)), static_cast<T &&>(args)...); }
         };
 
@@ -79,7 +92,7 @@ namespace boost { namespace yap {
         struct default_eval_expr_impl<expr_kind(-1)>
         {
             template <typename Expr, typename ...T>
-            decltype(auto) operator() (Expr && expr, T && ... args)
+            constexpr decltype(auto) operator() (Expr && expr, T && ... args)
             { return transform_expression(static_cast<Expr &&>(expr), static_cast<T &&>(args)...); }
         };
 
@@ -87,7 +100,7 @@ namespace boost { namespace yap {
         struct default_eval_expr_impl<expr_kind::terminal>
         {
             template <typename Expr, typename ...T>
-            decltype(auto) operator() (Expr && expr, T && ... args)
+            constexpr decltype(auto) operator() (Expr && expr, T && ... args)
             { return eval_terminal(::boost::yap::value(static_cast<Expr &&>(expr)), static_cast<T &&>(args)...); }
         };
 
@@ -96,7 +109,7 @@ namespace boost { namespace yap {
         struct default_eval_expr_impl<expr_kind:: op_name>              \
         {                                                               \
             template <typename Expr, typename ...T>                     \
-            decltype(auto) operator() (Expr && expr, T && ... args)     \
+            constexpr decltype(auto) operator() (Expr && expr, T && ... args) \
             {                                                           \
                 using namespace hana::literals;                         \
                 return eval_ ## op_name(                                \
@@ -123,7 +136,7 @@ namespace boost { namespace yap {
         struct default_eval_expr_impl<expr_kind:: op_name>              \
         {                                                               \
             template <typename Expr, typename ...T>                     \
-            decltype(auto) operator() (Expr && expr, T && ... args)     \
+            constexpr decltype(auto) operator() (Expr && expr, T && ... args) \
             {                                                           \
                 using namespace hana::literals;                         \
                 return eval_ ## op_name(                                \
@@ -156,7 +169,7 @@ namespace boost { namespace yap {
         struct default_eval_expr_impl<expr_kind::comma>
         {
             template <typename Expr, typename ...T>
-            decltype(auto) operator() (Expr && expr, T && ... args)
+            constexpr decltype(auto) operator() (Expr && expr, T && ... args)
             {
                 using namespace hana::literals;
                 return eval_comma(
@@ -186,7 +199,7 @@ namespace boost { namespace yap {
         struct default_eval_expr_impl<expr_kind::if_else>
         {
             template <typename Expr, typename ...T>
-            decltype(auto) operator() (Expr && expr, T && ... args)
+            constexpr decltype(auto) operator() (Expr && expr, T && ... args)
             {
                 using namespace hana::literals;
                 return eval_if_else(
@@ -201,7 +214,7 @@ namespace boost { namespace yap {
         struct default_eval_expr_impl<expr_kind::call>
         {
             template <typename Expr, typename ...T>
-            decltype(auto) operator() (Expr && expr, T && ... args)
+            constexpr decltype(auto) operator() (Expr && expr, T && ... args)
             {
                 decltype(auto) expand_args = [&](auto && element) {
                     return default_eval_expr(
@@ -222,7 +235,7 @@ namespace boost { namespace yap {
         };
 
         template <typename Expr, typename ...T>
-        decltype(auto) default_eval_expr (Expr && expr, T && ... args)
+        constexpr decltype(auto) default_eval_expr (Expr && expr, T && ... args)
         {
             constexpr bool transform_exists = !std::is_same<
                 decltype(transform_expression(static_cast<Expr &&>(expr), static_cast<T &&>(args)...)),
@@ -237,7 +250,7 @@ namespace boost { namespace yap {
 #else // BOOST_NO_CONSTEXPR_IF
 
         template <typename Expr, typename ...T>
-        decltype(auto) default_eval_expr (Expr && expr, T && ... args)
+        constexpr decltype(auto) default_eval_expr (Expr && expr, T && ... args)
         {
             constexpr expr_kind kind = remove_cv_ref_t<Expr>::kind;
 
@@ -363,7 +376,7 @@ namespace boost { namespace yap {
 
 
         template <typename Expr, typename Tuple, typename Transform>
-        decltype(auto) transform_nonterminal (Expr const & expr, Tuple && tuple, Transform && transform);
+        constexpr decltype(auto) transform_nonterminal (Expr const & expr, Tuple && tuple, Transform && transform);
 
 #ifdef BOOST_NO_CONSTEXPR_IF
 
@@ -392,7 +405,7 @@ namespace boost { namespace yap {
             IsTerminal,
             IsLvalueRef
         > {
-            decltype(auto) operator() (Expr && expr, Transform && transform)
+            constexpr decltype(auto) operator() (Expr && expr, Transform && transform)
             {
                 return ::boost::yap::transform(
                     ::boost::yap::deref(expr),
@@ -410,14 +423,14 @@ namespace boost { namespace yap {
             true,
             IsLvalueRef
         > {
-            decltype(auto) operator() (Expr && expr, Transform && transform)
+            constexpr decltype(auto) operator() (Expr && expr, Transform && transform)
             { return static_cast<Expr &&>(expr); }
         };
 
         template <typename Expr, typename Transform, expr_kind Kind>
         struct default_transform_expression_impl <Expr, Transform, Kind, false, false, true>
         {
-            decltype(auto) operator() (Expr && expr, Transform && transform)
+            constexpr decltype(auto) operator() (Expr && expr, Transform && transform)
             {
                 return transform_nonterminal(
                     expr,
@@ -430,7 +443,7 @@ namespace boost { namespace yap {
         template <typename Expr, typename Transform, expr_kind Kind>
         struct default_transform_expression_impl <Expr, Transform, Kind, false, false, false>
         {
-            decltype(auto) operator() (Expr && expr, Transform && transform)
+            constexpr decltype(auto) operator() (Expr && expr, Transform && transform)
             {
                 return transform_nonterminal(
                     expr,
@@ -453,7 +466,7 @@ namespace boost { namespace yap {
         template <typename Expr, typename Transform, typename = detail::void_t<>>
         struct default_transform_expression_expr
         {
-            decltype(auto) operator() (Expr && expr, Transform && transform)
+            constexpr decltype(auto) operator() (Expr && expr, Transform && transform)
             {
                 constexpr expr_kind kind = remove_cv_ref_t<Expr>::kind;
                 return default_transform_expression_impl<Expr, Transform, kind>{}(
@@ -468,7 +481,7 @@ namespace boost { namespace yap {
         template <typename Expr, typename Transform, typename = void_t<>>
         struct default_transform_expression_expr
         {
-            decltype(auto) operator() (Expr && expr, Transform && transform)
+            constexpr decltype(auto) operator() (Expr && expr, Transform && transform)
             {
                 constexpr expr_kind kind = remove_cv_ref_t<Expr>::kind;
                 if constexpr (kind == expr_kind::expr_ref) {
@@ -505,7 +518,7 @@ namespace boost { namespace yap {
             void_t<decltype(std::declval<Transform>()(std::declval<Expr>()))>
         >
         {
-            decltype(auto) operator() (Expr && expr, Transform && transform)
+            constexpr decltype(auto) operator() (Expr && expr, Transform && transform)
             { return static_cast<Transform &&>(transform)(static_cast<Expr &&>(expr)); }
         };
 
@@ -515,7 +528,7 @@ namespace boost { namespace yap {
         template <typename Expr, typename Transform, expr_arity Arity, typename>
         struct default_transform_expression_tag
         {
-            decltype(auto) operator() (Expr && expr, Transform && transform)
+            constexpr decltype(auto) operator() (Expr && expr, Transform && transform)
             {
                 return default_transform_expression_expr<Expr, Transform>{}(
                     static_cast<Expr &&>(expr),
@@ -525,21 +538,21 @@ namespace boost { namespace yap {
         };
 
         template <typename T, typename Transform>
-        decltype(auto) terminal_value (T && x, Transform && transform);
+        constexpr decltype(auto) terminal_value (T && x, Transform && transform);
 
 #ifdef BOOST_NO_CONSTEXPR_IF
 
         template <typename T, typename Transform, expr_kind Kind>
         struct terminal_value_expr_impl
         {
-            decltype(auto) operator() (T && x, Transform && transform)
+            constexpr decltype(auto) operator() (T && x, Transform && transform)
             { return static_cast<T &&>(x); }
         };
 
         template <typename T, typename Transform>
         struct terminal_value_expr_impl<T, Transform, expr_kind::terminal>
         {
-            decltype(auto) operator() (T && x, Transform && transform)
+            constexpr decltype(auto) operator() (T && x, Transform && transform)
             {
                 default_transform_expression_tag<T, Transform, detail::arity_of<expr_kind::terminal>()> transformer;
                 // This temporary is necessary.  The transform here may
@@ -555,7 +568,7 @@ namespace boost { namespace yap {
         template <typename T, typename Transform>
         struct terminal_value_expr_impl<T, Transform, expr_kind::expr_ref>
         {
-            decltype(auto) operator() (T && x, Transform && transform)
+            constexpr decltype(auto) operator() (T && x, Transform && transform)
             {
                 return terminal_value(
                     ::boost::yap::deref(static_cast<T &&>(x)),
@@ -567,7 +580,7 @@ namespace boost { namespace yap {
         template <typename T, typename Transform, bool IsExpr>
         struct terminal_value_impl_t
         {
-            decltype(auto) operator() (T && x, Transform && transform)
+            constexpr decltype(auto) operator() (T && x, Transform && transform)
             {
                 constexpr expr_kind kind = detail::remove_cv_ref_t<T>::kind;
                 return terminal_value_expr_impl<T, Transform, kind>{}(
@@ -580,12 +593,12 @@ namespace boost { namespace yap {
         template <typename T, typename Transform>
         struct terminal_value_impl_t<T, Transform, false>
         {
-            decltype(auto) operator() (T && x, Transform && transform)
+            constexpr decltype(auto) operator() (T && x, Transform && transform)
             { return static_cast<T &&>(x); }
         };
 
         template <typename T, typename Transform>
-        decltype(auto) terminal_value_impl (T && x, Transform && transform)
+        constexpr decltype(auto) terminal_value_impl (T && x, Transform && transform)
         {
             return detail::terminal_value_impl_t<T, Transform, is_expr<T>::value>{}(
                 static_cast<T &&>(x),
@@ -596,7 +609,7 @@ namespace boost { namespace yap {
 #else
 
         template <typename T, typename Transform>
-        decltype(auto) terminal_value_impl (T && x, Transform && transform)
+        constexpr decltype(auto) terminal_value_impl (T && x, Transform && transform)
         {
             if constexpr (is_expr<T>::value) {
                 constexpr expr_kind kind = remove_cv_ref_t<T>::kind;
@@ -625,7 +638,7 @@ namespace boost { namespace yap {
 #endif // BOOST_NO_CONSTEXPR_IF
 
         template <typename T, typename Transform>
-        decltype(auto) terminal_value (T && x, Transform && transform)
+        constexpr decltype(auto) terminal_value (T && x, Transform && transform)
         {
             return terminal_value_impl(
                 static_cast<T &&>(x),
@@ -647,7 +660,7 @@ namespace boost { namespace yap {
             )>
         >
         {
-            decltype(auto) operator() (Expr && expr, Transform && transform)
+            constexpr decltype(auto) operator() (Expr && expr, Transform && transform)
             {
                 using namespace hana::literals;
                 return static_cast<Transform &&>(transform)(
@@ -676,7 +689,7 @@ namespace boost { namespace yap {
             )>
         >
         {
-            decltype(auto) operator() (Expr && expr, Transform && transform)
+            constexpr decltype(auto) operator() (Expr && expr, Transform && transform)
             {
                 return static_cast<Transform &&>(transform)(
                     detail::tag_for<remove_cv_ref_t<Expr>::kind>(),
@@ -706,7 +719,7 @@ namespace boost { namespace yap {
             )>
         >
         {
-            decltype(auto) operator() (Expr && expr, Transform && transform)
+            constexpr decltype(auto) operator() (Expr && expr, Transform && transform)
             {
                 return static_cast<Transform &&>(transform)(
                     detail::tag_for<remove_cv_ref_t<Expr>::kind>(),
@@ -724,7 +737,7 @@ namespace boost { namespace yap {
         struct transform_call_unpacker
         {
             template <long long ...I>
-            auto operator() (
+            constexpr auto operator() (
                 Expr && expr,
                 Transform && transform,
                 std::integer_sequence<long long, I...>
@@ -774,7 +787,7 @@ namespace boost { namespace yap {
             )>
         >
         {
-            decltype(auto) operator() (Expr && expr, Transform && transform)
+            constexpr decltype(auto) operator() (Expr && expr, Transform && transform)
             {
                 return transform_call_unpacker<Expr, Transform>{}(
                     static_cast<Expr &&>(expr),
@@ -790,11 +803,11 @@ namespace boost { namespace yap {
             typename OldTuple,
             typename NewTuple
         >
-        auto make_expr_from_tuple (ExprTemplate<Kind, OldTuple> const & expr, NewTuple && tuple)
+        constexpr auto make_expr_from_tuple (ExprTemplate<Kind, OldTuple> const & expr, NewTuple && tuple)
         { return ExprTemplate<Kind, NewTuple>{std::move(tuple)}; }
 
         template <typename Expr, typename Tuple, typename Transform>
-        decltype(auto) transform_nonterminal (Expr const & expr, Tuple && tuple, Transform && transform)
+        constexpr decltype(auto) transform_nonterminal (Expr const & expr, Tuple && tuple, Transform && transform)
         {
             auto transformed_tuple = hana::transform(
                 static_cast<Tuple &&>(tuple),
@@ -28,10 +28,10 @@ namespace boost { namespace yap {
         static const expr_kind kind = Kind;
 
         /** Default constructor.  Does nothing. */
-        expression () {}
+        constexpr expression () {}
 
         /** Moves \a rhs into the only data mamber, \c elements. */
-        expression (tuple_type && rhs) :
+        constexpr expression (tuple_type && rhs) :
             elements (std::move(rhs))
         {}
 
@@ -51,45 +51,45 @@ namespace boost { namespace yap {
 
         /** A convenience member function that dispatches to the free function
             <code>value()</code>. */
-        decltype(auto) value () &
+        constexpr decltype(auto) value () &
         { return ::boost::yap::value(*this); }
 
 #ifndef BOOST_YAP_DOXYGEN
 
-        decltype(auto) value () const &
+        constexpr decltype(auto) value () const &
         { return ::boost::yap::value(*this); }
 
-        decltype(auto) value () &&
+        constexpr decltype(auto) value () &&
         { return ::boost::yap::value(std::move(*this)); }
 
 #endif
 
         /** A convenience member function that dispatches to the free function
             <code>left()</code>. */
-        decltype(auto) left () &
+        constexpr decltype(auto) left () &
         { return ::boost::yap::left(*this); }
 
 #ifndef BOOST_YAP_DOXYGEN
 
-        decltype(auto) left () const &
+        constexpr decltype(auto) left () const &
         { return ::boost::yap::left(*this); }
 
-        decltype(auto) left () &&
+        constexpr decltype(auto) left () &&
         { return ::boost::yap::left(std::move(*this)); }
 
 #endif
 
         /** A convenience member function that dispatches to the free function
             <code>right()</code>. */
-        decltype(auto) right () &
+        constexpr decltype(auto) right () &
         { return ::boost::yap::right(*this); }
 
 #ifndef BOOST_YAP_DOXYGEN
 
-        decltype(auto) right () const &
+        constexpr decltype(auto) right () const &
         { return ::boost::yap::right(*this); }
 
-        decltype(auto) right () &&
+        constexpr decltype(auto) right () &&
         { return ::boost::yap::right(std::move(*this)); }
 
 #endif
@@ -271,15 +271,15 @@ namespace boost { namespace yap {
         static const expr_kind kind = expr_kind::terminal;
 
         /** Default constructor.  Does nothing. */
-        expression () {}
+        constexpr expression () {}
 
         /** Forwards \a t into \c elements. */
-        expression (T && t) :
+        constexpr expression (T && t) :
             elements (static_cast<T &&>(t))
         {}
 
         /** Moves \a rhs into the only data mamber, \c elements. */
-        expression (hana::tuple<T> && rhs) :
+        constexpr expression (hana::tuple<T> && rhs) :
             elements (std::move(rhs))
         {}
 
@@ -299,15 +299,15 @@ namespace boost { namespace yap {
 
         /** A convenience member function that dispatches to the free function
             <code>value()</code>. */
-        decltype(auto) value () &
+        constexpr decltype(auto) value () &
         { return ::boost::yap::value(*this); }
 
 #ifndef BOOST_YAP_DOXYGEN
 
-        decltype(auto) value () const &
+        constexpr decltype(auto) value () const &
         { return ::boost::yap::value(*this); }
 
-        decltype(auto) value () &&
+        constexpr decltype(auto) value () &&
         { return ::boost::yap::value(std::move(*this)); }
 
 #endif
@@ -466,17 +466,17 @@ namespace boost { namespace yap {
 
     /** Returns <code>make_expression<boost::yap::expression, Kind>(...)</code>. */
     template <expr_kind Kind, typename ...T>
-    auto make_expression (T && ... t)
+    constexpr auto make_expression (T && ... t)
     { return make_expression<expression, Kind>(static_cast<T &&>(t)...); }
 
     /** Returns <code>make_terminal<boost::yap::expression>(t)</code>. */
     template <typename T>
-    auto make_terminal (T && t)
+    constexpr auto make_terminal (T && t)
     { return make_terminal<expression>(static_cast<T &&>(t)); }
 
     /** Returns <code>as_expr<boost::yap::expression>(t)</code>. */
     template <typename T>
-    decltype(auto) as_expr (T && t)
+    constexpr decltype(auto) as_expr (T && t)
     { return as_expr<expression>(static_cast<T &&>(t)); }
 
 } }
@@ -12,7 +12,7 @@ namespace boost { namespace yap {
 
     /** \see BOOST_YAP_USER_EXPR_IF_ELSE for full semantics. */
     template <typename Expr1, typename Expr2, typename Expr3>
-    auto if_else (Expr1 && expr1, Expr2 && expr2, Expr3 && expr3);
+    constexpr auto if_else (Expr1 && expr1, Expr2 && expr2, Expr3 && expr3);
 
 #endif
 
@@ -0,0 +1,363 @@
+#ifndef BOOST_YAP_HASH_HPP_INCLUDED
+#define BOOST_YAP_HASH_HPP_INCLUDED
+
+#include <boost/yap/algorithm.hpp>
+
+#include <boost/hana/for_each.hpp>
+#include <boost/type_index.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+
+
+namespace boost { namespace yap {
+
+    namespace detail {
+
+        inline std::uint64_t hash_combine (std::uint64_t seed, std::uint64_t x)
+        { return seed ^ (x + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2)); }
+
+
+        // strip_expr_refs
+
+        template <bool IsExprRef>
+        struct strip_expr_ref_fn
+        {
+            template <typename Expr>
+            Expr const & operator() (Expr const & expr)
+            { return expr; }
+        };
+
+        template <>
+        struct strip_expr_ref_fn<true>
+        {
+            template <typename Expr>
+            decltype(auto) operator() (Expr const & expr)
+            {
+                decltype(auto) referent = ::boost::yap::deref(expr);
+                using referent_type = remove_cv_ref_t<decltype(referent)>;
+                return strip_expr_ref_fn<referent_type::kind == expr_kind::expr_ref>{}(referent);
+            }
+        };
+
+        template <typename Expr>
+        decltype(auto) strip_expr_refs (Expr const & expr)
+        { return strip_expr_ref_fn<Expr::kind == expr_kind::expr_ref>{}(expr); }
+
+
+        // terminal value categories
+
+        template <typename T, typename = void_t<>>
+        struct is_std_hashable : std::false_type {};
+
+        template <typename T>
+        struct is_std_hashable<
+            T,
+            void_t<decltype(std::hash<T>{}(std::declval<T const &>()))>
+        > : std::true_type {};
+
+        enum class terminal_hash_category { reference, empty, value };
+
+        template <typename T>
+        constexpr terminal_hash_category terminal_hash_category_of ()
+        {
+            return std::is_reference<T>{} ?
+                terminal_hash_category::reference :
+                std::is_empty<remove_cv_ref_t<T>>{} ?
+                terminal_hash_category::empty :
+                terminal_hash_category::value;
+        }
+
+        template <typename T, terminal_hash_category Category = terminal_hash_category_of<T>()>
+        struct terminal_value_hasher
+        {
+            static_assert(
+                is_std_hashable<remove_cv_ref_t<T>>::value,
+                "structural_hash() and structurally_equal() require that each terminal "
+                "held by value is either an empty type or has a std::hash<> specialization."
+            );
+
+            std::uint64_t operator() (T const & x) const
+            { return std::hash<remove_cv_ref_t<T>>{}(x); }
+
+            bool equal (T const & x, T const & y) const
+            { return x == y; }
+        };
+
+        template <typename T>
+        struct terminal_value_hasher<T, terminal_hash_category::reference>
+        {
+            std::uint64_t operator() (T const & x) const
+            { return reinterpret_cast<std::uintptr_t>(std::addressof(x)); }
+
+            bool equal (T const & x, T const & y) const
+            { return std::addressof(x) == std::addressof(y); }
+        };
+
+        template <typename T>
+        struct terminal_value_hasher<T, terminal_hash_category::empty>
+        {
+            std::uint64_t operator() (T const &) const
+            { return 0; }
+
+            bool equal (T const &, T const &) const
+            { return true; }
+        };
+
+
+        // shape_hash
+
+        template <typename Expr, expr_kind Kind = Expr::kind>
+        struct shape_hash_impl;
+
+        template <typename Tuple>
+        struct shape_hash_elements;
+
+        template <typename ...T>
+        struct shape_hash_elements<hana::tuple<T...>>
+        {
+            static std::uint64_t compute (std::uint64_t seed)
+            {
+                using expand = int[];
+                (void)expand{0, (seed = hash_combine(seed, shape_hash_impl<strip_expr_ref_t<T>>::compute()), 0)...};
+                return seed;
+            }
+        };
+
+        template <typename Expr, expr_kind Kind>
+        struct shape_hash_impl
+        {
+            static std::uint64_t compute ()
+            {
+                using tuple_type = remove_cv_ref_t<decltype(std::declval<Expr>().elements)>;
+                return shape_hash_elements<tuple_type>::compute(
+                    hash_combine(0, static_cast<std::uint64_t>(Kind))
+                );
+            }
+        };
+
+        template <typename Expr>
+        struct shape_hash_impl<Expr, expr_kind::terminal>
+        {
+            static std::uint64_t compute ()
+            {
+                using element_type = terminal_element_t<Expr>;
+                std::uint64_t const seed = hash_combine(
+                    hash_combine(0, static_cast<std::uint64_t>(expr_kind::terminal)),
+                    typeindex::type_id<remove_cv_ref_t<element_type>>().hash_code()
+                );
+                return hash_combine(seed, std::is_reference<element_type>{} ? 1 : 0);
+            }
+        };
+
+        // The shape of an expression type never changes, so it is computed
+        // once per type and cached.
+        template <typename Expr>
+        std::uint64_t shape_hash ()
+        {
+            static std::uint64_t const retval = shape_hash_impl<strip_expr_ref_t<Expr>>::compute();
+            return retval;
+        }
+
+
+        // value_hash
+
+        template <expr_kind Kind>
+        struct value_hash_impl
+        {
+            template <typename Expr>
+            std::uint64_t operator() (std::uint64_t seed, Expr const & expr)
+            {
+                hana::for_each(expr.elements, [&seed](auto const & element) {
+                    using element_type = remove_cv_ref_t<decltype(element)>;
+                    seed = value_hash_impl<element_type::kind>{}(seed, element);
+                });
+                return seed;
+            }
+        };
+
+        template <>
+        struct value_hash_impl<expr_kind::expr_ref>
+        {
+            template <typename Expr>
+            std::uint64_t operator() (std::uint64_t seed, Expr const & expr)
+            {
+                decltype(auto) referent = ::boost::yap::deref(expr);
+                using referent_type = remove_cv_ref_t<decltype(referent)>;
+                return value_hash_impl<referent_type::kind>{}(seed, referent);
+            }
+        };
+
+        template <>
+        struct value_hash_impl<expr_kind::terminal>
+        {
+            template <typename Expr>
+            std::uint64_t operator() (std::uint64_t seed, Expr const & expr)
+            {
+                using element_type = terminal_element_t<Expr>;
+                return hash_combine(
+                    seed,
+                    terminal_value_hasher<element_type>{}(expr.elements[hana::llong_c<0>])
+                );
+            }
+        };
+
+
+        // shapes_equal
+
+        template <typename Expr1, typename Expr2, expr_kind Kind1 = Expr1::kind, expr_kind Kind2 = Expr2::kind>
+        struct shapes_equal_impl : std::false_type {};
+
+        template <typename Expr1, typename Expr2>
+        struct shapes_equal;
+
+        template <typename Expr1, typename Expr2, expr_kind Kind>
+        struct shapes_equal_impl<Expr1, Expr2, Kind, Kind> :
+            elementwise_all<
+                shapes_equal,
+                remove_cv_ref_t<decltype(std::declval<Expr1>().elements)>,
+                remove_cv_ref_t<decltype(std::declval<Expr2>().elements)>
+            >
+        {};
+
+        template <typename Expr1, typename Expr2>
+        struct shapes_equal_impl<Expr1, Expr2, expr_kind::terminal, expr_kind::terminal>
+        {
+            using element_type_1 = terminal_element_t<Expr1>;
+            using element_type_2 = terminal_element_t<Expr2>;
+            static bool const value =
+                std::is_same<remove_cv_ref_t<element_type_1>, remove_cv_ref_t<element_type_2>>{} &&
+                std::is_reference<element_type_1>{} == std::is_reference<element_type_2>{};
+        };
+
+        template <typename Expr1, typename Expr2>
+        struct shapes_equal :
+            shapes_equal_impl<strip_expr_ref_t<Expr1>, strip_expr_ref_t<Expr2>>
+        {};
+
+
+        // values_equal
+
+        template <typename Expr1, typename Expr2>
+        bool values_equal (Expr1 const & expr1, Expr2 const & expr2);
+
+        template <expr_kind Kind>
+        struct values_equal_impl
+        {
+            template <typename Expr1, typename Expr2>
+            bool operator() (Expr1 const & expr1, Expr2 const & expr2)
+            {
+                constexpr long long size = decltype(hana::size(expr1.elements))::value;
+                return elements_equal(expr1, expr2, hana::llong_c<0>, hana::llong_c<size>);
+            }
+
+            template <typename Expr1, typename Expr2, long long N>
+            bool elements_equal (Expr1 const &, Expr2 const &, hana::llong<N>, hana::llong<N>)
+            { return true; }
+
+            template <typename Expr1, typename Expr2, long long I, long long N>
+            bool elements_equal (Expr1 const & expr1, Expr2 const & expr2, hana::llong<I> i, hana::llong<N> n)
+            {
+                return
+                    values_equal(expr1.elements[i], expr2.elements[i]) &&
+                    elements_equal(expr1, expr2, hana::llong_c<I + 1>, n);
+            }
+        };
+
+        template <>
+        struct values_equal_impl<expr_kind::terminal>
+        {
+            template <typename Expr1, typename Expr2>
+            bool operator() (Expr1 const & expr1, Expr2 const & expr2)
+            {
+                using element_type = terminal_element_t<Expr1>;
+                return terminal_value_hasher<element_type>{}.equal(
+                    expr1.elements[hana::llong_c<0>],
+                    expr2.elements[hana::llong_c<0>]
+                );
+            }
+        };
+
+        template <typename Expr1, typename Expr2>
+        bool values_equal (Expr1 const & expr1, Expr2 const & expr2)
+        {
+            decltype(auto) stripped_1 = strip_expr_refs(expr1);
+            decltype(auto) stripped_2 = strip_expr_refs(expr2);
+            constexpr expr_kind kind = remove_cv_ref_t<decltype(stripped_1)>::kind;
+            return values_equal_impl<kind>{}(stripped_1, stripped_2);
+        }
+
+        template <bool ShapesEqual>
+        struct structurally_equal_impl
+        {
+            template <typename Expr1, typename Expr2>
+            bool operator() (Expr1 const &, Expr2 const &)
+            { return false; }
+        };
+
+        template <>
+        struct structurally_equal_impl<true>
+        {
+            template <typename Expr1, typename Expr2>
+            bool operator() (Expr1 const & expr1, Expr2 const & expr2)
+            { return values_equal(expr1, expr2); }
+        };
+
+    }
+
+    /** Returns a 64-bit hash of \a expr that combines its shape (the kind of
+        each node and the type of each terminal) with the runtime values of
+        its terminals.
+
+        Reference expressions are transparent; they hash the same as their
+        referents.  Terminals that hold references contribute the address of
+        the referent; terminals that hold empty types (such as placeholders)
+        contribute only their types; all other terminals contribute
+        <code>std::hash<></code> of their values.
+
+        The shape part of the hash is computed once per expression type.  As
+        with <code>std::hash<></code>, the result is only stable within a
+        single run of a program.
+
+        \note <code>structural_hash()</code> is only valid if each terminal
+        held by value is of an empty type or of a type with a
+        <code>std::hash<></code> specialization.
+    */
+    template <typename Expr>
+    std::uint64_t structural_hash (Expr const & expr)
+    {
+        static_assert(
+            is_expr<Expr>::value,
+            "structural_hash() is only defined for expressions."
+        );
+        return detail::value_hash_impl<Expr::kind>{}(detail::shape_hash<Expr>(), expr);
+    }
+
+    /** Returns true iff \a expr1 and \a expr2 have the same shape, and their
+        terminals compare equal pairwise.  Reference-holding terminals compare
+        equal when they refer to the same object; value-holding terminals are
+        compared with <code>operator==()</code>.
+
+        Shape comparison is done entirely at compile time, so expressions of
+        different shapes are never traversed.  If
+        <code>structurally_equal(expr1, expr2)</code> is true, then
+        <code>structural_hash(expr1) == structural_hash(expr2)</code>.
+    */
+    template <typename Expr1, typename Expr2>
+    bool structurally_equal (Expr1 const & expr1, Expr2 const & expr2)
+    {
+        static_assert(
+            is_expr<Expr1>::value && is_expr<Expr2>::value,
+            "structurally_equal() is only defined for expressions."
+        );
+        return detail::structurally_equal_impl<detail::shapes_equal<Expr1, Expr2>::value>{}(
+            expr1,
+            expr2
+        );
+    }
+
+} }
+
+#endif
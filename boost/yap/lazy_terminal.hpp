@@ -0,0 +1,100 @@
+#ifndef BOOST_YAP_LAZY_TERMINAL_HPP_INCLUDED
+#define BOOST_YAP_LAZY_TERMINAL_HPP_INCLUDED
+
+#include <boost/yap/algorithm.hpp>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+
+
+namespace boost { namespace yap {
+
+    /** A value that is computed by calling \a F the first time it is
+        needed, and cached thereafter.
+
+        Copies of a <code>lazy_value</code> share the callable and the cached
+        result, so the callable is called at most once no matter how many
+        copies exist or how many threads ask for the value.  The first call
+        is guarded by <code>std::call_once()</code>; every later call is a
+        single atomic load, and does not lock.  If the callable throws, the
+        exception propagates and the next request for the value calls it
+        again.
+    */
+    template <typename F>
+    struct lazy_value
+    {
+        using result_type = std::decay_t<decltype(std::declval<F &>()())>;
+
+        explicit lazy_value (F f) :
+            state_ (std::make_shared<state>(std::move(f)))
+        {}
+
+        /** Returns the cached result, calling the callable first if this is
+            the first time any copy of \c *this has been asked for it. */
+        result_type const & get () const
+        {
+            state & s = *state_;
+            if (!s.done.load(std::memory_order_acquire)) {
+                std::call_once(s.flag, [&s] {
+                    s.result.reset(new result_type(s.f()));
+                    s.done.store(true, std::memory_order_release);
+                });
+            }
+            return *s.result;
+        }
+
+        /** Returns <code>get()</code>.  This lets <code>value()</code> of a
+            lazy terminal, and a lazy terminal's value passed to a tag
+            transform, be used where a <code>result_type</code> is
+            expected. */
+        operator result_type const & () const
+        { return get(); }
+
+        /** Returns true iff the callable has already been called
+            successfully. */
+        bool computed () const
+        { return state_->done.load(std::memory_order_acquire); }
+
+    private:
+        struct state
+        {
+            explicit state (F f) :
+                f (std::move(f))
+            {}
+
+            F f;
+            std::once_flag flag;
+            std::atomic<bool> done {false};
+            std::unique_ptr<result_type> result;
+        };
+
+        std::shared_ptr<state> state_;
+    };
+
+    /** A convenience alias for a terminal expression holding a
+        <code>lazy_value<F></code>, instantiated from expression template \a
+        expr_template.
+
+        Evaluating such a terminal yields the cached result of calling \a F,
+        as described for <code>lazy_value</code>.
+    */
+    template <template <expr_kind, class> class expr_template, typename F>
+    using lazy_terminal = terminal<expr_template, lazy_value<F>>;
+
+    /** Makes a new lazy terminal instantiated from the expression template
+        \a ExprTemplate, whose value is computed by calling \a f the first
+        time the terminal is evaluated. */
+    template <template <expr_kind, class> class ExprTemplate, typename F>
+    auto make_lazy_terminal (F && f)
+    {
+        return make_terminal<ExprTemplate>(
+            lazy_value<std::decay_t<F>>(static_cast<F &&>(f))
+        );
+    }
+
+} }
+
+#endif
@@ -0,0 +1,682 @@
+#ifndef BOOST_YAP_REWRITE_HPP_INCLUDED
+#define BOOST_YAP_REWRITE_HPP_INCLUDED
+
+#include <boost/yap/algorithm.hpp>
+
+#include <initializer_list>
+#include <tuple>
+#include <utility>
+
+
+namespace boost { namespace yap {
+
+    /** A single rewrite rule, as created by <code>rule()</code>.
+
+        \a Pattern is an expression type in which each placeholder is a
+        wildcard that matches any subexpression.  \a Replacement is either an
+        expression in which each placeholder stands for the subexpression
+        bound to it by the pattern, or a callable that is passed the bound
+        subexpressions in placeholder order.
+    */
+    template <typename Pattern, typename Replacement>
+    struct rewrite_rule
+    {
+        using pattern_type = Pattern;
+        using replacement_type = Replacement;
+
+        Replacement replacement;
+    };
+
+    namespace detail {
+
+        constexpr long long sum_of (std::initializer_list<long long> values)
+        {
+            long long retval = 0;
+            for (long long value : values) {
+                retval += value;
+            }
+            return retval;
+        }
+
+        constexpr long long max_of (std::initializer_list<long long> values)
+        {
+            long long retval = 0;
+            for (long long value : values) {
+                if (retval < value)
+                    retval = value;
+            }
+            return retval;
+        }
+
+
+        // placeholder_index_of
+
+        template <typename T>
+        struct placeholder_index : std::integral_constant<long long, 0> {};
+
+        template <long long I>
+        struct placeholder_index<placeholder<I>> : std::integral_constant<long long, I> {};
+
+        template <typename Expr, bool IsTerminal = Expr::kind == expr_kind::terminal>
+        struct placeholder_index_of : std::integral_constant<long long, 0> {};
+
+        template <typename Expr>
+        struct placeholder_index_of<Expr, true> :
+            placeholder_index<remove_cv_ref_t<terminal_element_t<Expr>>>
+        {};
+
+
+        // placeholder_count
+
+        template <typename Expr, long long I, bool IsTerminal = Expr::kind == expr_kind::terminal>
+        struct placeholder_count :
+            std::integral_constant<long long, placeholder_index_of<Expr>::value == I ? 1 : 0>
+        {};
+
+        template <typename Tuple, long long I>
+        struct element_placeholder_count;
+
+        template <typename ...T, long long I>
+        struct element_placeholder_count<hana::tuple<T...>, I> :
+            std::integral_constant<
+                long long,
+                sum_of({placeholder_count<strip_expr_ref_t<T>, I>::value...})
+            >
+        {};
+
+        template <typename Expr, long long I>
+        struct placeholder_count<Expr, I, false> :
+            element_placeholder_count<remove_cv_ref_t<decltype(std::declval<Expr>().elements)>, I>
+        {};
+
+
+        // max_placeholder
+
+        template <typename Expr, bool IsTerminal = Expr::kind == expr_kind::terminal>
+        struct max_placeholder : placeholder_index_of<Expr> {};
+
+        template <typename Tuple>
+        struct element_max_placeholder;
+
+        template <typename ...T>
+        struct element_max_placeholder<hana::tuple<T...>> :
+            std::integral_constant<long long, max_of({max_placeholder<strip_expr_ref_t<T>>::value...})>
+        {};
+
+        template <typename Expr>
+        struct max_placeholder<Expr, false> :
+            element_max_placeholder<remove_cv_ref_t<decltype(std::declval<Expr>().elements)>>
+        {};
+
+
+        // placeholders_unique
+
+        template <typename Expr, typename Indices>
+        struct placeholders_unique_impl;
+
+        template <typename Expr, long long ...I>
+        struct placeholders_unique_impl<Expr, std::integer_sequence<long long, I...>> :
+            all_true<(placeholder_count<Expr, I + 1>::value <= 1)...>
+        {};
+
+        template <typename Expr>
+        struct placeholders_unique :
+            placeholders_unique_impl<
+                Expr,
+                std::make_integer_sequence<long long, max_placeholder<Expr>::value>
+            >
+        {};
+
+
+        // pattern_matches
+
+        template <typename Pattern, typename Expr>
+        struct pattern_matches;
+
+        template <
+            typename Pattern,
+            typename Expr,
+            expr_kind PatternKind = Pattern::kind,
+            expr_kind ExprKind = Expr::kind
+        >
+        struct pattern_matches_impl : std::false_type {};
+
+        template <typename Pattern, typename Expr, expr_kind Kind>
+        struct pattern_matches_impl<Pattern, Expr, Kind, Kind> :
+            elementwise_all<
+                pattern_matches,
+                remove_cv_ref_t<decltype(std::declval<Pattern>().elements)>,
+                remove_cv_ref_t<decltype(std::declval<Expr>().elements)>
+            >
+        {};
+
+        template <typename Pattern, typename Expr, expr_kind ExprKind>
+        struct pattern_matches_impl<Pattern, Expr, expr_kind::terminal, ExprKind> :
+            std::integral_constant<bool, placeholder_index_of<Pattern>::value != 0>
+        {};
+
+        template <typename Pattern, typename Expr>
+        struct pattern_matches_impl<Pattern, Expr, expr_kind::terminal, expr_kind::terminal> :
+            std::integral_constant<
+                bool,
+                placeholder_index_of<Pattern>::value != 0 ||
+                std::is_same<
+                    remove_cv_ref_t<terminal_element_t<Pattern>>,
+                    remove_cv_ref_t<terminal_element_t<Expr>>
+                >{}
+            >
+        {};
+
+        template <typename Pattern, typename Expr>
+        struct pattern_matches :
+            pattern_matches_impl<strip_expr_ref_t<Pattern>, strip_expr_ref_t<Expr>>
+        {};
+
+
+        // first_matching_rule
+
+        template <typename Expr, typename ...Rules>
+        constexpr long long first_matching_rule ()
+        {
+            bool const matches[] = {
+                false,
+                pattern_matches<typename Rules::pattern_type, Expr>::value...
+            };
+            for (long long i = 0; i < (long long)sizeof...(Rules); ++i) {
+                if (matches[i + 1])
+                    return i;
+            }
+            return -1;
+        }
+
+
+        // matches_anywhere
+
+        template <typename Expr, typename RuleTuple, bool IsTerminal = Expr::kind == expr_kind::terminal>
+        struct matches_anywhere;
+
+        template <typename Tuple, typename RuleTuple>
+        struct element_matches_anywhere;
+
+        template <typename ...T, typename RuleTuple>
+        struct element_matches_anywhere<hana::tuple<T...>, RuleTuple> :
+            any_true<matches_anywhere<strip_expr_ref_t<T>, RuleTuple>::value...>
+        {};
+
+        template <typename Expr, typename ...Rules>
+        struct matches_anywhere<Expr, std::tuple<Rules...>, true> :
+            std::integral_constant<bool, first_matching_rule<Expr, Rules...>() != -1>
+        {};
+
+        template <typename Expr, typename ...Rules>
+        struct matches_anywhere<Expr, std::tuple<Rules...>, false> :
+            std::integral_constant<
+                bool,
+                first_matching_rule<Expr, Rules...>() != -1 ||
+                element_matches_anywhere<
+                    remove_cv_ref_t<decltype(std::declval<Expr>().elements)>,
+                    std::tuple<Rules...>
+                >::value
+            >
+        {};
+
+
+        // forward_element
+
+        template <long long I, typename Expr>
+        decltype(auto) forward_element (Expr && expr)
+        { return static_cast<Expr &&>(expr).elements[hana::llong_c<I>]; }
+
+
+        // make_expr_like
+
+        template <
+            expr_kind Kind,
+            template <expr_kind, class> class ExprTemplate,
+            expr_kind OldKind,
+            typename OldTuple,
+            typename ...T
+        >
+        auto make_expr_like (ExprTemplate<OldKind, OldTuple> const *, T && ... t)
+        { return make_expression<ExprTemplate, Kind>(static_cast<T &&>(t)...); }
+
+        template <
+            template <expr_kind, class> class ExprTemplate,
+            expr_kind OldKind,
+            typename OldTuple,
+            typename T
+        >
+        auto make_terminal_like (ExprTemplate<OldKind, OldTuple> const *, T && t)
+        { return make_terminal<ExprTemplate>(static_cast<T &&>(t)); }
+
+        template <typename T>
+        auto copy_of (T const & x)
+        { return x; }
+
+
+        // bind_placeholder
+
+        template <long long I, typename Pattern, typename Expr>
+        decltype(auto) bind_placeholder (Expr && expr);
+
+        template <
+            long long I,
+            typename Pattern,
+            bool IsExprRef,
+            bool IsPlaceholder = placeholder_index_of<Pattern>::value == I
+        >
+        struct bind_placeholder_impl
+        {
+            template <typename ...T>
+            static constexpr long long child_index (hana::tuple<T...> *)
+            {
+                bool const contains[] = {
+                    false,
+                    (placeholder_count<strip_expr_ref_t<T>, I>::value != 0)...
+                };
+                for (long long i = 0; i < (long long)sizeof...(T); ++i) {
+                    if (contains[i + 1])
+                        return i;
+                }
+                return -1;
+            }
+
+            template <typename Expr>
+            decltype(auto) operator() (Expr && expr)
+            {
+                using pattern_tuple = remove_cv_ref_t<decltype(std::declval<Pattern>().elements)>;
+                constexpr long long i = child_index((pattern_tuple *)nullptr);
+                static_assert(0 <= i, "Placeholder not found in pattern.");
+                using child_pattern = strip_expr_ref_t<
+                    decltype(std::declval<pattern_tuple>()[hana::llong_c<i>])
+                >;
+                return bind_placeholder<I, child_pattern>(forward_element<i>(static_cast<Expr &&>(expr)));
+            }
+        };
+
+        // The referent of a reference expression is not ours to move from,
+        // so it is always bound as an lvalue.
+        template <long long I, typename Pattern, bool IsPlaceholder>
+        struct bind_placeholder_impl<I, Pattern, true, IsPlaceholder>
+        {
+            template <typename Expr>
+            decltype(auto) operator() (Expr && expr)
+            { return bind_placeholder<I, Pattern>(::boost::yap::deref(expr)); }
+        };
+
+        template <long long I, typename Pattern>
+        struct bind_placeholder_impl<I, Pattern, false, true>
+        {
+            template <typename Expr>
+            decltype(auto) operator() (Expr && expr)
+            { return static_cast<Expr &&>(expr); }
+        };
+
+        template <long long I, typename Pattern, typename Expr>
+        decltype(auto) bind_placeholder (Expr && expr)
+        {
+            constexpr bool is_expr_ref = remove_cv_ref_t<Expr>::kind == expr_kind::expr_ref;
+            return bind_placeholder_impl<I, Pattern, is_expr_ref>{}(static_cast<Expr &&>(expr));
+        }
+
+
+        // substitute
+
+        template <typename Pattern, typename Root, typename Replacement, typename Expr>
+        decltype(auto) substitute (Replacement const & replacement, Expr && expr);
+
+        template <typename Pattern, typename Root, typename Replacement, expr_kind Kind = Replacement::kind>
+        struct substitute_impl
+        {
+            template <typename Expr, long long ...I>
+            auto substitute_elements (
+                Replacement const & replacement,
+                Expr && expr,
+                std::integer_sequence<long long, I...>)
+            {
+                return make_expr_like<Kind>(
+                    (std::remove_reference_t<Expr> *)nullptr,
+                    substitute<Pattern, Root>(
+                        replacement.elements[hana::llong_c<I>],
+                        static_cast<Expr &&>(expr)
+                    )...
+                );
+            }
+
+            template <typename Expr>
+            auto operator() (Replacement const & replacement, Expr && expr)
+            {
+                return substitute_elements(
+                    replacement,
+                    static_cast<Expr &&>(expr),
+                    indices_for(replacement)
+                );
+            }
+        };
+
+        template <typename Pattern, typename Root, typename Replacement>
+        struct substitute_impl<Pattern, Root, Replacement, expr_kind::expr_ref>
+        {
+            template <typename Expr>
+            decltype(auto) operator() (Replacement const & replacement, Expr && expr)
+            {
+                return substitute<Pattern, Root>(
+                    ::boost::yap::deref(replacement),
+                    static_cast<Expr &&>(expr)
+                );
+            }
+        };
+
+        template <typename Pattern, long long I, bool Copy, bool IsPlaceholder = I != 0>
+        struct substitute_terminal_impl
+        {
+            template <typename Replacement, typename Expr>
+            auto operator() (Replacement const & replacement, Expr && expr)
+            {
+                return make_terminal_like(
+                    (std::remove_reference_t<Expr> *)nullptr,
+                    copy_of(replacement.elements[hana::llong_c<0>])
+                );
+            }
+        };
+
+        template <typename Pattern, long long I>
+        struct substitute_terminal_impl<Pattern, I, false, true>
+        {
+            template <typename Replacement, typename Expr>
+            decltype(auto) operator() (Replacement const & replacement, Expr && expr)
+            { return bind_placeholder<I, Pattern>(static_cast<Expr &&>(expr)); }
+        };
+
+        // A placeholder used more than once in a replacement cannot be moved
+        // into each use, so each use gets its own copy.
+        template <typename Pattern, long long I>
+        struct substitute_terminal_impl<Pattern, I, true, true>
+        {
+            template <typename Replacement, typename Expr>
+            auto operator() (Replacement const & replacement, Expr && expr)
+            { return copy_of(bind_placeholder<I, Pattern>(static_cast<Expr &&>(expr))); }
+        };
+
+        template <typename Pattern, typename Root, typename Replacement>
+        struct substitute_impl<Pattern, Root, Replacement, expr_kind::terminal>
+        {
+            template <typename Expr>
+            decltype(auto) operator() (Replacement const & replacement, Expr && expr)
+            {
+                constexpr long long i = placeholder_index_of<Replacement>::value;
+                static_assert(
+                    i == 0 || placeholder_count<Pattern, i>::value == 1,
+                    "Each placeholder used in a rewrite rule's replacement must appear in its pattern."
+                );
+                constexpr bool copy = 1 < placeholder_count<Root, i>::value;
+                return substitute_terminal_impl<Pattern, i, copy>{}(
+                    replacement,
+                    static_cast<Expr &&>(expr)
+                );
+            }
+        };
+
+        template <typename Pattern, typename Root, typename Replacement, typename Expr>
+        decltype(auto) substitute (Replacement const & replacement, Expr && expr)
+        {
+            return substitute_impl<Pattern, Root, Replacement>{}(
+                replacement,
+                static_cast<Expr &&>(expr)
+            );
+        }
+
+
+        // apply_rule
+
+        template <
+            template <expr_kind, class> class ExprTemplate,
+            expr_kind OldKind,
+            typename OldTuple,
+            typename T
+        >
+        auto make_operand_like (ExprTemplate<OldKind, OldTuple> const *, T && t)
+        {
+            using operand_type = operand_type_t<ExprTemplate, T>;
+            return make_operand<operand_type>{}(static_cast<T &&>(t));
+        }
+
+        template <typename Pattern, typename Replacement, bool IsExpr = is_expr<Replacement>::value>
+        struct apply_rule_impl
+        {
+            template <typename Expr, long long ...I>
+            auto call (
+                Replacement const & replacement,
+                Expr && expr,
+                std::integer_sequence<long long, I...>)
+            {
+                return replacement(bind_placeholder<I + 1, Pattern>(static_cast<Expr &&>(expr))...);
+            }
+
+            template <typename Expr>
+            auto operator() (Replacement const & replacement, Expr && expr)
+            {
+                return make_operand_like(
+                    (std::remove_reference_t<Expr> *)nullptr,
+                    call(
+                        replacement,
+                        static_cast<Expr &&>(expr),
+                        std::make_integer_sequence<long long, max_placeholder<Pattern>::value>()
+                    )
+                );
+            }
+        };
+
+        template <typename Pattern, typename Replacement>
+        struct apply_rule_impl<Pattern, Replacement, true>
+        {
+            template <typename Expr>
+            auto operator() (Replacement const & replacement, Expr && expr)
+            {
+                return make_operand_like(
+                    (std::remove_reference_t<Expr> *)nullptr,
+                    substitute<Pattern, strip_expr_ref_t<Replacement>>(
+                        replacement,
+                        static_cast<Expr &&>(expr)
+                    )
+                );
+            }
+        };
+
+        template <typename Expr, typename Rules>
+        decltype(auto) rewrite_impl (Expr && expr, Rules const & rules);
+
+        template <typename RuleTuple, long long RuleIndex>
+        struct rewrite_root
+        {
+            template <typename Expr>
+            auto operator() (Expr && expr, RuleTuple const & rules)
+            {
+                auto const & rule = std::get<RuleIndex>(rules);
+                using rule_type = remove_cv_ref_t<decltype(rule)>;
+                using pattern_type = typename rule_type::pattern_type;
+                using replacement_type = typename rule_type::replacement_type;
+                auto replaced = apply_rule_impl<pattern_type, replacement_type>{}(
+                    rule.replacement,
+                    static_cast<Expr &&>(expr)
+                );
+                return rewrite_impl(std::move(replaced), rules);
+            }
+        };
+
+        template <typename RuleTuple>
+        struct rewrite_root<RuleTuple, -1>
+        {
+            template <typename Expr>
+            auto operator() (Expr && expr, RuleTuple const & rules)
+            { return remove_cv_ref_t<Expr>(static_cast<Expr &&>(expr)); }
+        };
+
+        template <typename Expr, typename RuleTuple>
+        struct root_rule_index;
+
+        template <typename Expr, typename ...Rules>
+        struct root_rule_index<Expr, std::tuple<Rules const &...>> :
+            std::integral_constant<long long, first_matching_rule<Expr, Rules...>()>
+        {};
+
+        template <typename Expr, typename RuleTuple>
+        struct matches_anywhere_in;
+
+        template <typename Expr, typename ...Rules>
+        struct matches_anywhere_in<Expr, std::tuple<Rules const &...>> :
+            matches_anywhere<Expr, std::tuple<Rules...>>
+        {};
+
+        enum class rewrite_case { unchanged, expr_ref, terminal, nonterminal };
+
+        template <typename Expr, typename RuleTuple>
+        constexpr rewrite_case rewrite_case_of ()
+        {
+            using stripped_type = strip_expr_ref_t<Expr>;
+            return !matches_anywhere_in<stripped_type, RuleTuple>::value ?
+                rewrite_case::unchanged :
+                remove_cv_ref_t<Expr>::kind == expr_kind::expr_ref ?
+                rewrite_case::expr_ref :
+                remove_cv_ref_t<Expr>::kind == expr_kind::terminal ?
+                rewrite_case::terminal :
+                rewrite_case::nonterminal;
+        }
+
+        // An lvalue comes back as a reference to itself; an rvalue is moved
+        // into the result, so that it cannot dangle.
+        template <rewrite_case Case>
+        struct rewrite_impl_t
+        {
+            template <typename Expr, typename RuleTuple>
+            Expr operator() (Expr && expr, RuleTuple const & rules)
+            { return static_cast<Expr &&>(expr); }
+        };
+
+        template <>
+        struct rewrite_impl_t<rewrite_case::expr_ref>
+        {
+            template <typename Expr, typename RuleTuple>
+            auto operator() (Expr && expr, RuleTuple const & rules)
+            { return rewrite_impl(::boost::yap::deref(expr), rules); }
+        };
+
+        template <>
+        struct rewrite_impl_t<rewrite_case::terminal>
+        {
+            template <typename Expr, typename RuleTuple>
+            auto operator() (Expr && expr, RuleTuple const & rules)
+            {
+                constexpr long long rule_index =
+                    root_rule_index<remove_cv_ref_t<Expr>, RuleTuple>::value;
+                return rewrite_root<RuleTuple, rule_index>{}(static_cast<Expr &&>(expr), rules);
+            }
+        };
+
+        template <>
+        struct rewrite_impl_t<rewrite_case::nonterminal>
+        {
+            template <typename Expr, typename RuleTuple, long long ...I>
+            auto rewrite_elements (
+                Expr && expr,
+                RuleTuple const & rules,
+                std::integer_sequence<long long, I...>)
+            {
+                constexpr expr_kind kind = remove_cv_ref_t<Expr>::kind;
+                return make_expr_like<kind>(
+                    (std::remove_reference_t<Expr> *)nullptr,
+                    rewrite_impl(forward_element<I>(static_cast<Expr &&>(expr)), rules)...
+                );
+            }
+
+            template <typename Expr, typename RuleTuple>
+            auto operator() (Expr && expr, RuleTuple const & rules)
+            {
+                auto rebuilt = rewrite_elements(static_cast<Expr &&>(expr), rules, indices_for(expr));
+                constexpr long long rule_index =
+                    root_rule_index<decltype(rebuilt), RuleTuple>::value;
+                return rewrite_root<RuleTuple, rule_index>{}(std::move(rebuilt), rules);
+            }
+        };
+
+        template <typename Expr, typename RuleTuple>
+        decltype(auto) rewrite_impl (Expr && expr, RuleTuple const & rules)
+        {
+            return rewrite_impl_t<rewrite_case_of<Expr, RuleTuple>()>{}(
+                static_cast<Expr &&>(expr),
+                rules
+            );
+        }
+
+    }
+
+    /** Returns a rewrite rule that replaces each subexpression matching \a
+        pattern with \a replacement.
+
+        Within \a pattern, each placeholder is a wildcard that matches any
+        subexpression, each terminal that is not a placeholder matches any
+        terminal of the same value type, and each other node matches nodes of
+        the same <code>expr_kind</code> whose operands all match.  Matching is
+        decided entirely from the types involved, at compile time.
+
+        If \a replacement is an expression, the result of the rewrite is \a
+        replacement with each placeholder substituted by the subexpression it
+        matched; the other terminals in \a replacement are copied.  Otherwise,
+        \a replacement must be a callable; it is passed the subexpressions
+        matched by placeholders <code>1_p</code>, <code>2_p</code>, ... in
+        that order, and the result of the rewrite is what it returns (wrapped
+        in a terminal if it is not an expression).
+
+        \note <code>rule()</code> is only valid if \a pattern is an
+        expression that is not just a placeholder, and in which each
+        placeholder appears at most once.
+    */
+    template <typename Pattern, typename Replacement>
+    auto rule (Pattern const & pattern, Replacement && replacement)
+    {
+        static_assert(
+            is_expr<Pattern>::value,
+            "rule() is only defined for expression patterns."
+        );
+        using pattern_type = detail::strip_expr_ref_t<Pattern>;
+        static_assert(
+            detail::placeholder_index_of<pattern_type>::value == 0,
+            "A rewrite rule's pattern may not be a lone placeholder; it would match everything, forever."
+        );
+        static_assert(
+            detail::placeholders_unique<pattern_type>::value,
+            "Each placeholder may appear at most once in a rewrite rule's pattern."
+        );
+        return rewrite_rule<pattern_type, detail::remove_cv_ref_t<Replacement>>{
+            static_cast<Replacement &&>(replacement)
+        };
+    }
+
+    /** Rewrites \a expr bottom-up with \a rules until no rule matches any
+        subexpression of the result.
+
+        Operands are rewritten before the nodes that contain them.  At each
+        node, the first of \a rules whose pattern matches is applied, and the
+        result of that is itself rewritten.  Since matching depends only on
+        types, the fixpoint is found at compile time; a set of rules that
+        never reaches one fails to compile instead of looping at run time.
+
+        Subexpressions that no rule can match anywhere are forwarded into the
+        result unchanged, following the usual rules: lvalues are captured by
+        reference, and rvalues are moved.  If no rule matches anywhere in \a
+        expr, the result is \a expr itself: a reference to it if it is an
+        lvalue, or a copy moved from it if it is an rvalue.
+    */
+    template <typename Expr, typename ...Rules>
+    decltype(auto) rewrite (Expr && expr, Rules const & ... rules)
+    {
+        static_assert(
+            is_expr<Expr>::value,
+            "rewrite() is only defined for expressions."
+        );
+        return detail::rewrite_impl(static_cast<Expr &&>(expr), std::tuple<Rules const &...>(rules...));
+    }
+
+} }
+
+#endif
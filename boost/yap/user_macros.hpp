@@ -84,7 +84,7 @@
     ExpressionTemplate.
 */
 #define BOOST_YAP_USER_UNARY_OPERATOR_MEMBER(op_name, expr_template)    \
-    auto operator BOOST_YAP_INDIRECT_CALL(op_name)(()) const &          \
+    constexpr auto operator BOOST_YAP_INDIRECT_CALL(op_name)(()) const & \
     {                                                                   \
         using this_type = ::boost::yap::detail::remove_cv_ref_t<decltype(*this)>; \
         using lhs_type = ::boost::yap::detail::operand_type_t<expr_template, this_type const &>; \
@@ -95,7 +95,7 @@
             }                                                           \
         };                                                              \
     }                                                                   \
-    auto operator BOOST_YAP_INDIRECT_CALL(op_name)(()) &                \
+    constexpr auto operator BOOST_YAP_INDIRECT_CALL(op_name)(()) &      \
     {                                                                   \
         using this_type = ::boost::yap::detail::remove_cv_ref_t<decltype(*this)>; \
         using lhs_type = ::boost::yap::detail::operand_type_t<expr_template, this_type &>; \
@@ -106,7 +106,7 @@
             }                                                           \
         };                                                              \
     }                                                                   \
-    auto operator BOOST_YAP_INDIRECT_CALL(op_name)(()) &&               \
+    constexpr auto operator BOOST_YAP_INDIRECT_CALL(op_name)(()) &&     \
     {                                                                   \
         using this_type = ::boost::yap::detail::remove_cv_ref_t<decltype(*this)>; \
         using tuple_type = ::boost::hana::tuple<this_type>;             \
@@ -141,7 +141,7 @@
 */
 #define BOOST_YAP_USER_BINARY_OPERATOR_MEMBER(op_name, expr_template)   \
     template <typename Expr>                                            \
-    auto operator BOOST_YAP_INDIRECT_CALL(op_name)() (Expr && rhs) const & \
+    constexpr auto operator BOOST_YAP_INDIRECT_CALL(op_name)() (Expr && rhs) const & \
     {                                                                   \
         using this_type = ::boost::yap::detail::remove_cv_ref_t<decltype(*this)>; \
         using lhs_type = ::boost::yap::detail::operand_type_t<expr_template, this_type const &>; \
@@ -155,7 +155,7 @@
         };                                                              \
     }                                                                   \
     template <typename Expr>                                            \
-    auto operator BOOST_YAP_INDIRECT_CALL(op_name)() (Expr && rhs) &    \
+    constexpr auto operator BOOST_YAP_INDIRECT_CALL(op_name)() (Expr && rhs) & \
     {                                                                   \
         using this_type = ::boost::yap::detail::remove_cv_ref_t<decltype(*this)>; \
         using lhs_type = ::boost::yap::detail::operand_type_t<expr_template, this_type &>; \
@@ -169,7 +169,7 @@
         };                                                              \
     }                                                                   \
     template <typename Expr>                                            \
-    auto operator BOOST_YAP_INDIRECT_CALL(op_name)() (Expr && rhs) &&   \
+    constexpr auto operator BOOST_YAP_INDIRECT_CALL(op_name)() (Expr && rhs) && \
     {                                                                   \
         using this_type = ::boost::yap::detail::remove_cv_ref_t<decltype(*this)>; \
         using rhs_type = ::boost::yap::detail::operand_type_t<expr_template, Expr>; \
@@ -204,7 +204,7 @@
 */
 #define BOOST_YAP_USER_MEMBER_CALL_OPERATOR(expr_template)              \
     template <typename ...U>                                            \
-    auto operator() (U && ... u) const &                                \
+    constexpr auto operator() (U && ... u) const &                      \
     {                                                                   \
         using this_type = ::boost::yap::detail::remove_cv_ref_t<decltype(*this)>; \
         using lhs_type = ::boost::yap::detail::operand_type_t<expr_template, this_type const &>; \
@@ -222,7 +222,7 @@
         };                                                              \
     }                                                                   \
     template <typename ...U>                                            \
-    auto operator() (U && ... u) &                                      \
+    constexpr auto operator() (U && ... u) &                            \
     {                                                                   \
         using this_type = ::boost::yap::detail::remove_cv_ref_t<decltype(*this)>; \
         using lhs_type = ::boost::yap::detail::operand_type_t<expr_template, this_type &>; \
@@ -240,7 +240,7 @@
         };                                                              \
     }                                                                   \
     template <typename ...U>                                            \
-    auto operator() (U && ... u) &&                                     \
+    constexpr auto operator() (U && ... u) &&                           \
     {                                                                   \
         using this_type = ::boost::yap::detail::remove_cv_ref_t<decltype(*this)>; \
         using tuple_type = ::boost::hana::tuple<                        \
@@ -286,7 +286,7 @@
         ::boost::yap::expr_kind Kind,                                   \
         typename Tuple                                                  \
     >                                                                   \
-    auto operator BOOST_YAP_INDIRECT_CALL(op_name)() (                  \
+    constexpr auto operator BOOST_YAP_INDIRECT_CALL(op_name)() (        \
         T && lhs,                                                       \
         ExprTemplate<Kind, Tuple> && rhs                                \
     ) -> ::boost::yap::detail::free_binary_op_result_t<                 \
@@ -312,7 +312,7 @@
         };                                                              \
     }                                                                   \
     template <typename T, typename Expr>                                \
-    auto operator BOOST_YAP_INDIRECT_CALL(op_name)() (T && lhs, Expr & rhs) \
+    constexpr auto operator BOOST_YAP_INDIRECT_CALL(op_name)() (T && lhs, Expr & rhs) \
         -> ::boost::yap::detail::free_binary_op_result_t<               \
             expr_template,                                              \
             ::boost::yap::expr_kind::op_name,                           \
@@ -359,7 +359,7 @@
 */
 #define BOOST_YAP_USER_EXPR_IF_ELSE(expr_template)                      \
     template <typename Expr1, typename Expr2, typename Expr3>           \
-    auto if_else (Expr1 && expr1, Expr2 && expr2, Expr3 && expr3)       \
+    constexpr auto if_else (Expr1 && expr1, Expr2 && expr2, Expr3 && expr3) \
         -> ::boost::yap::detail::ternary_op_result_t<                   \
             expr_template,                                              \
             Expr1,                                                      \
@@ -409,7 +409,7 @@
 */
 #define BOOST_YAP_USER_UDT_ANY_IF_ELSE(expr_template, udt_trait)        \
     template <typename Expr1, typename Expr2, typename Expr3>           \
-    auto if_else (Expr1 && expr1, Expr2 && expr2, Expr3 && expr3)       \
+    constexpr auto if_else (Expr1 && expr1, Expr2 && expr2, Expr3 && expr3) \
         -> ::boost::yap::detail::udt_any_ternary_op_result_t<           \
             expr_template,                                              \
             Expr1,                                                      \
@@ -464,7 +464,7 @@
 */
 #define BOOST_YAP_USER_UDT_UNARY_OPERATOR(op_name, expr_template, udt_trait) \
     template <typename T>                                               \
-    auto operator BOOST_YAP_INDIRECT_CALL(op_name)((T && x))            \
+    constexpr auto operator BOOST_YAP_INDIRECT_CALL(op_name)((T && x))  \
         -> ::boost::yap::detail::udt_unary_op_result_t<                 \
             expr_template,                                              \
             ::boost::yap::expr_kind::op_name,                           \
@@ -517,7 +517,7 @@
 */
 #define BOOST_YAP_USER_UDT_UDT_BINARY_OPERATOR(op_name, expr_template, t_udt_trait, u_udt_trait) \
     template <typename T, typename U>                                   \
-    auto operator BOOST_YAP_INDIRECT_CALL(op_name)() (T && lhs, U && rhs) \
+    constexpr auto operator BOOST_YAP_INDIRECT_CALL(op_name)() (T && lhs, U && rhs) \
         -> ::boost::yap::detail::udt_udt_binary_op_result_t<            \
             expr_template,                                              \
             ::boost::yap::expr_kind::op_name,                           \
@@ -575,7 +575,7 @@
 */
 #define BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(op_name, expr_template, udt_trait) \
     template <typename T, typename U>                                   \
-    auto operator BOOST_YAP_INDIRECT_CALL(op_name)() (T && lhs, U && rhs) \
+    constexpr auto operator BOOST_YAP_INDIRECT_CALL(op_name)() (T && lhs, U && rhs) \
         -> ::boost::yap::detail::udt_any_binary_op_result_t<            \
             expr_template,                                              \
             ::boost::yap::expr_kind::op_name,                           \
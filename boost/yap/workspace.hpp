@@ -0,0 +1,275 @@
+#ifndef BOOST_YAP_WORKSPACE_HPP_INCLUDED
+#define BOOST_YAP_WORKSPACE_HPP_INCLUDED
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+
+
+namespace boost { namespace yap {
+
+    struct workspace;
+
+    /** A buffer of \a T acquired from a <code>workspace</code>.  It is
+        returned to the workspace when it is destroyed.  The elements are
+        uninitialized when the buffer is acquired.
+
+        \note A buffer must be destroyed or released before the workspace
+        it came from is destroyed. */
+    template <typename T>
+    struct workspace_buffer
+    {
+        static_assert(
+            std::is_trivial<T>::value,
+            "workspace_buffer<T> requires a trivial T, since its elements are "
+            "neither constructed nor destroyed."
+        );
+
+        workspace_buffer () :
+            workspace_ (nullptr),
+            data_ (nullptr),
+            size_ (0),
+            size_class_ (0)
+        {}
+
+        workspace_buffer (workspace_buffer && other) :
+            workspace_ (other.workspace_),
+            data_ (other.data_),
+            size_ (other.size_),
+            size_class_ (other.size_class_)
+        {
+            other.workspace_ = nullptr;
+            other.data_ = nullptr;
+            other.size_ = 0;
+        }
+
+        workspace_buffer & operator= (workspace_buffer && other)
+        {
+            if (this != &other) {
+                release();
+                workspace_ = other.workspace_;
+                data_ = other.data_;
+                size_ = other.size_;
+                size_class_ = other.size_class_;
+                other.workspace_ = nullptr;
+                other.data_ = nullptr;
+                other.size_ = 0;
+            }
+            return *this;
+        }
+
+        workspace_buffer (workspace_buffer const &) = delete;
+        workspace_buffer & operator= (workspace_buffer const &) = delete;
+
+        ~workspace_buffer ()
+        { release(); }
+
+        T * data () const { return data_; }
+        std::size_t size () const { return size_; }
+        bool empty () const { return size_ == 0; }
+
+        T * begin () const { return data_; }
+        T * end () const { return data_ + size_; }
+
+        T & operator[] (std::size_t n) const
+        {
+            assert(n < size_);
+            return data_[n];
+        }
+
+        /** Returns the buffer to its workspace, leaving \c *this empty. */
+        void release ();
+
+    private:
+        workspace_buffer (workspace * ws, T * data, std::size_t size, std::size_t size_class) :
+            workspace_ (ws),
+            data_ (data),
+            size_ (size),
+            size_class_ (size_class)
+        {}
+
+        workspace * workspace_;
+        T * data_;
+        std::size_t size_;
+        std::size_t size_class_;
+
+        friend struct workspace;
+    };
+
+    /** A pool of reusable memory for the temporaries of an evaluation.
+
+        Buffers are handed out in power-of-two size classes, aligned to
+        <code>workspace::alignment</code> bytes.  A released buffer is kept
+        for reuse by the next request in the same size class, so once a
+        workspace has served one round of requests, serving the same round
+        again performs no heap allocations.  Memory goes back to the heap
+        only when the workspace is destroyed or <code>trim()</code> is
+        called.
+
+        Every buffer acquired from a workspace must be destroyed or
+        released before the workspace is.
+
+        A workspace is not thread-safe; use one per thread.  It can be passed
+        explicitly to code that needs temporaries, or installed as the
+        current thread's workspace with a <code>workspace_scope</code>, and
+        obtained with <code>current_workspace()</code>.
+    */
+    struct workspace
+    {
+        static constexpr std::size_t alignment = 64;
+
+        workspace () :
+            free_ {},
+            allocations_ (0)
+        {}
+
+        workspace (workspace const &) = delete;
+        workspace & operator= (workspace const &) = delete;
+
+        ~workspace ()
+        { trim(); }
+
+        /** Returns a buffer of \a n uninitialized elements of \a T.
+
+            \throw std::bad_alloc if \a n elements of \a T are more bytes
+            than the largest size class, or than the heap can provide. */
+        template <typename T>
+        workspace_buffer<T> acquire (std::size_t n)
+        {
+            if (!n)
+                return workspace_buffer<T>();
+            if (std::size_t(-1) / sizeof(T) < n)
+                throw std::bad_alloc();
+            std::size_t const size_class = size_class_of(n * sizeof(T));
+            return workspace_buffer<T>(this, static_cast<T *>(take(size_class)), n, size_class);
+        }
+
+        /** Frees all the buffers that are not currently acquired. */
+        void trim ()
+        {
+            for (free_block * & head : free_) {
+                while (head) {
+                    free_block * const next = head->next;
+                    deallocate(head);
+                    head = next;
+                }
+            }
+        }
+
+        /** Returns the number of times this workspace has allocated memory
+            from the heap. */
+        std::size_t allocations () const
+        { return allocations_; }
+
+    private:
+        struct free_block
+        {
+            free_block * next;
+        };
+
+        static constexpr std::size_t min_size_class = 6; // alignment bytes
+        static constexpr std::size_t size_classes = sizeof(std::size_t) * 8;
+
+        static std::size_t size_class_of (std::size_t bytes)
+        {
+            if ((std::size_t(1) << (size_classes - 1)) < bytes)
+                throw std::bad_alloc();
+            std::size_t retval = min_size_class;
+            while ((std::size_t(1) << retval) < bytes) {
+                ++retval;
+            }
+            return retval;
+        }
+
+        void * take (std::size_t size_class)
+        {
+            if (free_block * const block = free_[size_class]) {
+                free_[size_class] = block->next;
+                return block;
+            }
+            ++allocations_;
+            return allocate(std::size_t(1) << size_class);
+        }
+
+        void give_back (void * ptr, std::size_t size_class)
+        {
+            free_block * const block = ::new (ptr) free_block{free_[size_class]};
+            free_[size_class] = block;
+        }
+
+        // Returns bytes bytes aligned to alignment.  The pointer returned by
+        // operator new is stored just before them.
+        static void * allocate (std::size_t bytes)
+        {
+            char * const raw = static_cast<char *>(::operator new(bytes + alignment + sizeof(void *)));
+            std::uintptr_t const aligned =
+                (reinterpret_cast<std::uintptr_t>(raw) + sizeof(void *) + alignment - 1) & ~(alignment - 1);
+            void ** const retval = reinterpret_cast<void **>(aligned);
+            retval[-1] = raw;
+            return retval;
+        }
+
+        static void deallocate (void * ptr)
+        { ::operator delete(static_cast<void **>(ptr)[-1]); }
+
+        free_block * free_[size_classes];
+        std::size_t allocations_;
+
+        template <typename T>
+        friend struct workspace_buffer;
+    };
+
+    template <typename T>
+    void workspace_buffer<T>::release ()
+    {
+        if (data_)
+            workspace_->give_back(data_, size_class_);
+        workspace_ = nullptr;
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+    namespace detail {
+
+        inline workspace *& installed_workspace ()
+        {
+            thread_local workspace * retval = nullptr;
+            return retval;
+        }
+
+    }
+
+    /** Returns the workspace installed for the current thread by the
+        innermost active <code>workspace_scope</code>, or, if there is none, a
+        workspace owned by the current thread. */
+    inline workspace & current_workspace ()
+    {
+        if (workspace * installed = detail::installed_workspace())
+            return *installed;
+        thread_local workspace default_workspace;
+        return default_workspace;
+    }
+
+    /** Installs a workspace as the current thread's workspace for the
+        lifetime of the scope object, and then restores the previous one. */
+    struct workspace_scope
+    {
+        explicit workspace_scope (workspace & ws) :
+            previous_ (detail::installed_workspace())
+        { detail::installed_workspace() = &ws; }
+
+        workspace_scope (workspace_scope const &) = delete;
+        workspace_scope & operator= (workspace_scope const &) = delete;
+
+        ~workspace_scope ()
+        { detail::installed_workspace() = previous_; }
+
+    private:
+        workspace * previous_;
+    };
+
+} }
+
+#endif
@@ -0,0 +1,201 @@
+//[ bitset
+#include <boost/yap/yap.hpp>
+
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+
+//[ bitset_type
+// A packed sequence of bools: bit i is bit i % 64 of words[i / 64].  Bits
+// past size are always zero.
+struct bitset
+{
+    bool test (std::size_t i) const
+    { return words[i / 64] >> (i % 64) & 1; }
+
+    std::size_t count () const
+    {
+        std::size_t retval = 0;
+        for (std::uint64_t word : words) {
+            retval += __builtin_popcountll(word);
+        }
+        return retval;
+    }
+
+    std::vector<std::uint64_t> words;
+    std::size_t size;
+};
+
+bitset make_bitset (std::size_t size)
+{ return bitset{std::vector<std::uint64_t>((size + 63) / 64), size}; }
+
+// std::vector<bool> is packed too, but does not expose its words, so it is
+// copied into a bitset one bit at a time.
+bitset make_bitset (std::vector<bool> const & bools)
+{
+    bitset retval = make_bitset(bools.size());
+    for (std::size_t i = 0; i < bools.size(); ++i) {
+        retval.words[i / 64] |= std::uint64_t(bools[i]) << (i % 64);
+    }
+    return retval;
+}
+//]
+
+// Define a type trait that identifies bitsets.
+template <typename T>
+struct is_bitset : std::false_type {};
+
+template <>
+struct is_bitset<bitset> : std::true_type {};
+
+BOOST_YAP_USER_UDT_UNARY_OPERATOR(logical_not, boost::yap::expression, is_bitset); // !
+BOOST_YAP_USER_UDT_UNARY_OPERATOR(complement, boost::yap::expression, is_bitset); // ~
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(logical_and, boost::yap::expression, is_bitset); // &&
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(logical_or, boost::yap::expression, is_bitset); // ||
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(bitwise_and, boost::yap::expression, is_bitset); // &
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(bitwise_or, boost::yap::expression, is_bitset); // |
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(bitwise_xor, boost::yap::expression, is_bitset); // ^
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(equal_to, boost::yap::expression, is_bitset); // ==
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(not_equal_to, boost::yap::expression, is_bitset); // !=
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(less, boost::yap::expression, is_bitset); // <
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(greater, boost::yap::expression, is_bitset); // >
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(less_equal, boost::yap::expression, is_bitset); // <=
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(greater_equal, boost::yap::expression, is_bitset); // >=
+BOOST_YAP_USER_UDT_ANY_IF_ELSE(boost::yap::expression, is_bitset);
+
+
+//[ bitset_word_xform
+// Evaluates one 64-bit word of a boolean expression over bitsets.  Each
+// bitset terminal becomes its w-th word, and each bool terminal a word of all
+// ones or all zeros; then every operator is applied to 64 rows at once.
+struct word_at
+{
+    std::uint64_t operator() (boost::yap::terminal_tag, bitset const & b) const
+    { return b.words[w]; }
+
+    std::uint64_t operator() (boost::yap::terminal_tag, bool b) const
+    { return b ? ~std::uint64_t(0) : 0; }
+
+    // Define a mapping from each boolean operator's tag type to its bitwise
+    // equivalent.  Comparisons order false before true, as bool does.
+    static std::uint64_t word_op (boost::yap::logical_not_tag, std::uint64_t x) { return ~x; }
+    static std::uint64_t word_op (boost::yap::complement_tag, std::uint64_t x) { return ~x; }
+
+    static std::uint64_t word_op (boost::yap::logical_and_tag, std::uint64_t x, std::uint64_t y) { return x & y; }
+    static std::uint64_t word_op (boost::yap::logical_or_tag, std::uint64_t x, std::uint64_t y) { return x | y; }
+    static std::uint64_t word_op (boost::yap::bitwise_and_tag, std::uint64_t x, std::uint64_t y) { return x & y; }
+    static std::uint64_t word_op (boost::yap::bitwise_or_tag, std::uint64_t x, std::uint64_t y) { return x | y; }
+    static std::uint64_t word_op (boost::yap::bitwise_xor_tag, std::uint64_t x, std::uint64_t y) { return x ^ y; }
+    static std::uint64_t word_op (boost::yap::equal_to_tag, std::uint64_t x, std::uint64_t y) { return ~(x ^ y); }
+    static std::uint64_t word_op (boost::yap::not_equal_to_tag, std::uint64_t x, std::uint64_t y) { return x ^ y; }
+    static std::uint64_t word_op (boost::yap::less_tag, std::uint64_t x, std::uint64_t y) { return ~x & y; }
+    static std::uint64_t word_op (boost::yap::greater_tag, std::uint64_t x, std::uint64_t y) { return x & ~y; }
+    static std::uint64_t word_op (boost::yap::less_equal_tag, std::uint64_t x, std::uint64_t y) { return ~x | y; }
+    static std::uint64_t word_op (boost::yap::greater_equal_tag, std::uint64_t x, std::uint64_t y) { return x | ~y; }
+
+    static std::uint64_t word_op (boost::yap::if_else_tag, std::uint64_t c, std::uint64_t x, std::uint64_t y)
+    { return (c & x) | (~c & y); }
+
+    // ... and use it to handle all the operators.  Terminal operands arrive
+    // here already replaced by words; transform() passes those through.
+    template <typename Tag, typename ...Exprs>
+    auto operator() (Tag tag, Exprs const & ... exprs) const ->
+        decltype(word_op(tag, (void(sizeof(Exprs)), std::uint64_t())...))
+    { return word_op(tag, std::uint64_t(boost::yap::transform(exprs, *this))...); }
+
+    std::size_t w;
+};
+//]
+
+// The number of rows in expr, taken from its bitset terminals.
+struct bitset_size
+{
+    template <typename Expr>
+    auto operator() (std::size_t size, Expr const & expr) ->
+        decltype(boost::yap::value(expr).words, std::size_t())
+    { return std::max(size, boost::yap::value(expr).size); }
+};
+
+// True iff every bitset terminal that the running value is folded over has
+// size bits.
+struct sizes_match
+{
+    template <typename Expr>
+    auto operator() (bool match, Expr const & expr) ->
+        decltype(boost::yap::value(expr).words, bool())
+    { return match && boost::yap::value(expr).size == size; }
+
+    std::size_t size;
+};
+
+//[ bitset_assign
+// Assigns the boolean expression expr to result, one word at a time.  The
+// words are computed into a new bitset, so that expr may refer to result.
+template <typename Expr>
+bitset & assign (bitset & result, Expr const & expr)
+{
+    std::size_t const size = boost::yap::fold(expr, std::size_t(0), bitset_size{});
+    assert(boost::yap::fold(expr, true, sizes_match{size}));
+    bitset retval = make_bitset(size);
+    for (std::size_t w = 0; w < retval.words.size(); ++w) {
+        retval.words[w] = boost::yap::transform(expr, word_at{w});
+    }
+    if (size % 64)
+        retval.words.back() &= (std::uint64_t(1) << size % 64) - 1;
+    result = std::move(retval);
+    return result;
+}
+//]
+
+int main ()
+{
+    std::size_t const n = 1000;
+
+    std::vector<bool> in_stock_bools(n);
+    std::vector<bool> on_sale_bools(n);
+    std::vector<bool> discontinued_bools(n);
+    std::vector<bool> premium_bools(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        in_stock_bools[i] = i % 3 != 0;
+        on_sale_bools[i] = i % 5 == 0;
+        discontinued_bools[i] = i % 7 == 0;
+        premium_bools[i] = i % 2 == 0;
+    }
+
+    bitset const in_stock = make_bitset(in_stock_bools);
+    bitset const on_sale = make_bitset(on_sale_bools);
+    bitset const discontinued = make_bitset(discontinued_bools);
+    bitset const premium = make_bitset(premium_bools);
+
+    bitset result;
+    assign(result, in_stock && (on_sale || premium) && !discontinued);
+    std::cout << result.count() << " of " << result.size << " rows selected\n";
+
+    for (std::size_t i = 0; i < n; ++i) {
+        bool const expected =
+            in_stock_bools[i] && (on_sale_bools[i] || premium_bools[i]) && !discontinued_bools[i];
+        assert(result.test(i) == expected);
+        (void)expected;
+    }
+
+    // Comparisons, and mixing in bool scalars.
+    assign(result, (on_sale != premium) == true);
+    std::cout << result.count() << " rows are on sale or premium, but not both\n";
+
+    assign(result, in_stock < on_sale);
+    for (std::size_t i = 0; i < n; ++i) {
+        assert(result.test(i) == (in_stock_bools[i] < on_sale_bools[i]));
+    }
+
+    // The result may appear in its own expression.
+    assign(result, result && premium);
+    for (std::size_t i = 0; i < n; ++i) {
+        assert(result.test(i) == (in_stock_bools[i] < on_sale_bools[i] && premium_bools[i]));
+    }
+
+    return 0;
+}
+//]
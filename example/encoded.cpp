@@ -0,0 +1,357 @@
+//[ encoded
+#include <boost/yap/yap.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+
+//[ encoded_columns
+// A run-length encoded column.  Run i holds values[i] for the rows up to, but
+// not including, ends[i].
+template <typename T>
+struct rle_column
+{
+    std::size_t size () const
+    { return ends.empty() ? 0 : ends.back(); }
+
+    std::size_t run_at (std::size_t row) const
+    { return std::upper_bound(ends.begin(), ends.end(), row) - ends.begin(); }
+
+    std::vector<T> values;
+    std::vector<std::size_t> ends;
+};
+
+// A dictionary-encoded column.  Row i holds dictionary[codes[i]].
+template <typename T>
+struct dict_column
+{
+    std::size_t size () const
+    { return codes.size(); }
+
+    std::vector<T> dictionary;
+    std::vector<std::uint32_t> codes;
+};
+//]
+
+template <typename T>
+rle_column<T> rle_encode (std::vector<T> const & vec)
+{
+    rle_column<T> retval;
+    for (std::size_t i = 0; i < vec.size(); ++i) {
+        if (retval.values.empty() || !(retval.values.back() == vec[i])) {
+            retval.values.push_back(vec[i]);
+            retval.ends.push_back(i + 1);
+        } else {
+            ++retval.ends.back();
+        }
+    }
+    return retval;
+}
+
+template <typename T>
+dict_column<T> dict_encode (std::vector<T> const & vec)
+{
+    dict_column<T> retval;
+    for (T const & x : vec) {
+        auto const it = std::find(retval.dictionary.begin(), retval.dictionary.end(), x);
+        retval.codes.push_back(std::uint32_t(it - retval.dictionary.begin()));
+        if (it == retval.dictionary.end())
+            retval.dictionary.push_back(x);
+    }
+    return retval;
+}
+
+// Define a type trait that identifies column types.
+template <typename T>
+struct is_column : std::false_type {};
+
+template <typename T, typename A>
+struct is_column<std::vector<T, A>> : std::true_type {};
+
+template <typename T>
+struct is_column<rle_column<T>> : std::true_type {};
+
+template <typename T>
+struct is_column<dict_column<T>> : std::true_type {};
+
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(multiplies, boost::yap::expression, is_column); // *
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(divides, boost::yap::expression, is_column); // /
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(plus, boost::yap::expression, is_column); // +
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(minus, boost::yap::expression, is_column); // -
+
+
+//[ encoded_transforms
+// Replaces each run-length encoded terminal with its value at row.
+struct bind_runs
+{
+    template <typename T>
+    auto operator() (boost::yap::terminal_tag, rle_column<T> const & column)
+    { return boost::yap::make_terminal(column.values[column.run_at(row)]); }
+
+    std::size_t row;
+};
+
+// Replaces each terminal with its value at row n.  Run-length encoded
+// terminals are found by binary search, so in a loop, bind_runs should be
+// applied first.
+struct take_nth
+{
+    template <typename T>
+    auto operator() (boost::yap::terminal_tag, std::vector<T> const & vec)
+    { return boost::yap::make_terminal(vec[n]); }
+
+    template <typename T>
+    auto operator() (boost::yap::terminal_tag, rle_column<T> const & column)
+    { return boost::yap::make_terminal(column.values[column.run_at(n)]); }
+
+    template <typename T>
+    auto operator() (boost::yap::terminal_tag, dict_column<T> const & column)
+    { return boost::yap::make_terminal(column.dictionary[column.codes[n]]); }
+
+    std::size_t n;
+};
+
+// Replaces each dictionary-encoded terminal with its k-th distinct value.
+struct take_distinct
+{
+    template <typename T>
+    auto operator() (boost::yap::terminal_tag, dict_column<T> const & column)
+    { return boost::yap::make_terminal(column.dictionary[k]); }
+
+    std::size_t k;
+};
+//]
+
+
+//[ encoded_iteration_space
+// The number of each kind of column terminal in an expression.  Folding an
+// expression with count_kinds produces a different column_kinds<> type for
+// each combination, so the counts are known at compile time.
+template <std::size_t Plain, std::size_t Rle, std::size_t Dict>
+struct column_kinds
+{
+    static constexpr std::size_t plain = Plain;
+    static constexpr std::size_t rle = Rle;
+    static constexpr std::size_t dict = Dict;
+
+    template <typename T>
+    column_kinds<Plain + 1, Rle, Dict> add (std::vector<T> const &) const { return {}; }
+    template <typename T>
+    column_kinds<Plain, Rle + 1, Dict> add (rle_column<T> const &) const { return {}; }
+    template <typename T>
+    column_kinds<Plain, Rle, Dict + 1> add (dict_column<T> const &) const { return {}; }
+};
+
+struct count_kinds
+{
+    template <typename Kinds, typename Expr>
+    auto operator() (Kinds kinds, Expr const & expr) ->
+        decltype(kinds.add(boost::yap::value(expr)))
+    { return kinds.add(boost::yap::value(expr)); }
+};
+
+// The number of rows in expr, taken from its columns.
+struct column_size
+{
+    template <typename Expr>
+    auto operator() (std::size_t size, Expr const & expr) ->
+        decltype(boost::yap::value(expr).size())
+    { return std::max(size, boost::yap::value(expr).size()); }
+};
+
+// True iff every column that the running value is folded over has size
+// rows.
+struct sizes_match
+{
+    template <typename Expr>
+    auto operator() (bool match, Expr const & expr) ->
+        decltype(boost::yap::value(expr).size(), bool())
+    { return match && boost::yap::value(expr).size() == size; }
+
+    std::size_t size;
+};
+
+// The codes of expr's dictionary-encoded column.
+struct dict_codes
+{
+    template <typename Expr>
+    auto operator() (std::vector<std::uint32_t> const *, Expr const & expr) ->
+        decltype(&boost::yap::value(expr).codes)
+    { return &boost::yap::value(expr).codes; }
+};
+
+// Collects the run ends of every run-length encoded terminal.
+struct collect_run_ends
+{
+    template <typename Expr>
+    auto operator() (std::vector<std::size_t> ends, Expr const & expr) ->
+        decltype(boost::yap::value(expr).ends, std::vector<std::size_t>())
+    {
+        auto const & column_ends = boost::yap::value(expr).ends;
+        ends.insert(ends.end(), column_ends.begin(), column_ends.end());
+        return ends;
+    }
+};
+
+template <typename Expr>
+std::size_t row_count (Expr const & expr)
+{
+    std::size_t const rows = boost::yap::fold(expr, std::size_t(0), column_size{});
+    assert(boost::yap::fold(expr, true, sizes_match{rows}));
+    return rows;
+}
+
+template <typename Expr>
+using row_value_t = std::decay_t<decltype(boost::yap::evaluate(
+    boost::yap::transform(std::declval<Expr const &>(), take_nth{0})
+))>;
+
+// The ends of the ranges of rows over which every run-length encoded column
+// of expr has a single value.
+template <typename Expr>
+std::vector<std::size_t> segment_ends (Expr const & expr)
+{
+    std::vector<std::size_t> ends =
+        boost::yap::fold(expr, std::vector<std::size_t>{}, collect_run_ends{});
+    ends.push_back(row_count(expr));
+    std::sort(ends.begin(), ends.end());
+    ends.erase(std::unique(ends.begin(), ends.end()), ends.end());
+    return ends;
+}
+
+enum class iteration_space { per_distinct_value, per_run, per_row };
+
+template <iteration_space Space>
+using iteration_space_constant = std::integral_constant<iteration_space, Space>;
+
+// The cheapest iteration space that the kinds of columns in expr allow:
+//
+// - If the only column is dictionary encoded, expr is evaluated once per
+//   distinct value, and the results are gathered through the codes.
+//
+// - If every column is run-length encoded, the rows are split wherever any
+//   of them starts a new run, and expr is evaluated once per such segment.
+//
+// - Otherwise, expr is evaluated once per row.  Its run-length encoded
+//   columns are still only looked up once per segment.
+template <typename Expr>
+constexpr iteration_space iteration_space_of ()
+{
+    using kinds = decltype(boost::yap::fold(
+        std::declval<Expr const &>(), column_kinds<0, 0, 0>{}, count_kinds{}
+    ));
+    return
+        kinds::dict == 1 && !kinds::plain && !kinds::rle ? iteration_space::per_distinct_value :
+        !kinds::plain && !kinds::dict ? iteration_space::per_run :
+        iteration_space::per_row;
+}
+
+template <typename Expr, typename F>
+void for_each_segment (Expr const & expr, F & f, iteration_space_constant<iteration_space::per_distinct_value>)
+{
+    std::vector<std::uint32_t> const & codes =
+        *boost::yap::fold(expr, static_cast<std::vector<std::uint32_t> const *>(nullptr), dict_codes{});
+    std::size_t const distinct =
+        codes.empty() ? 0 : *std::max_element(codes.begin(), codes.end()) + 1;
+    std::vector<row_value_t<Expr>> per_value;
+    per_value.reserve(distinct);
+    for (std::size_t k = 0; k < distinct; ++k) {
+        per_value.push_back(boost::yap::evaluate(boost::yap::transform(expr, take_distinct{k})));
+    }
+    for (std::size_t i = 0; i < codes.size(); ++i) {
+        f(i, i + 1, per_value[codes[i]]);
+    }
+}
+
+template <typename Expr, typename F>
+void for_each_segment (Expr const & expr, F & f, iteration_space_constant<iteration_space::per_run>)
+{
+    std::size_t first = 0;
+    for (std::size_t last : segment_ends(expr)) {
+        if (last == first)
+            continue;
+        f(first, last, boost::yap::evaluate(boost::yap::transform(expr, bind_runs{first})));
+        first = last;
+    }
+}
+
+template <typename Expr, typename F>
+void for_each_segment (Expr const & expr, F & f, iteration_space_constant<iteration_space::per_row>)
+{
+    std::size_t first = 0;
+    for (std::size_t last : segment_ends(expr)) {
+        auto const bound = boost::yap::transform(expr, bind_runs{first});
+        for (std::size_t i = first; i < last; ++i) {
+            f(i, i + 1, boost::yap::evaluate(boost::yap::transform(bound, take_nth{i})));
+        }
+        first = last;
+    }
+}
+
+// Calls f(first, last, value) for consecutive ranges of rows [first, last)
+// that cover all the rows of expr, where value is the value of expr for
+// every row in the range.
+template <typename Expr, typename F>
+void for_each_segment (Expr const & expr, F f)
+{ for_each_segment(expr, f, iteration_space_constant<iteration_space_of<Expr>()>{}); }
+//]
+
+//[ encoded_consumers
+template <typename Expr>
+auto sum (Expr const & expr)
+{
+    using value_type = row_value_t<Expr>;
+    value_type retval(0);
+    for_each_segment(expr, [&](std::size_t first, std::size_t last, value_type const & value) {
+        retval += value * value_type(last - first);
+    });
+    return retval;
+}
+
+template <typename Expr>
+auto decode (Expr const & expr)
+{
+    using value_type = row_value_t<Expr>;
+    std::vector<value_type> retval(row_count(expr));
+    for_each_segment(expr, [&](std::size_t first, std::size_t last, value_type const & value) {
+        std::fill(retval.begin() + first, retval.begin() + last, value);
+    });
+    return retval;
+}
+//]
+
+int main ()
+{
+    std::vector<double> price_raw;
+    std::vector<double> tax_raw;
+    std::vector<double> quantity;
+    for (std::size_t i = 0; i < 1000; ++i) {
+        price_raw.push_back(i < 600 ? 2.0 : 3.0);
+        tax_raw.push_back(i % 250 < 200 ? 0.25 : 0.5);
+        quantity.push_back(double(i % 4));
+    }
+
+    rle_column<double> const price = rle_encode(price_raw);
+    rle_column<double> const tax = rle_encode(tax_raw);
+    dict_column<double> const tax_dict = dict_encode(tax_raw);
+
+    // 9 segments, each evaluated once.
+    std::cout << "sum(price * (1 + tax)) = " << sum(price * (1.0 + tax)) << "\n";
+
+    // 2 distinct values, each evaluated once.
+    std::cout << "sum(1 + tax) = " << sum(1.0 + tax_dict) << "\n";
+
+    // Evaluated once per row, with price bound once per run.
+    std::cout << "sum(price * quantity) = " << sum(price * quantity) << "\n";
+
+    std::vector<double> const decoded = decode(price * tax_dict);
+    assert(decoded.size() == 1000u);
+    assert(decoded[0] == 0.5 && decoded[200] == 1.0 && decoded[999] == 1.5);
+    (void)decoded;
+
+    return 0;
+}
+//]
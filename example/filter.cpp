@@ -0,0 +1,155 @@
+//[ filter
+#include <boost/yap/yap.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <tuple>
+#include <vector>
+
+
+//[ filter_take_nth_xform
+struct take_nth
+{
+    template <typename T>
+    auto operator() (boost::yap::terminal_tag, std::vector<T> const & vec)
+    { return boost::yap::make_terminal(vec[n]); }
+
+    std::size_t n;
+};
+//]
+
+// Define a type trait that identifies std::vectors.
+template <typename T>
+struct is_vector : std::false_type {};
+
+template <typename T, typename A>
+struct is_vector<std::vector<T, A>> : std::true_type {};
+
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(multiplies, boost::yap::expression, is_vector); // *
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(plus, boost::yap::expression, is_vector); // +
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(minus, boost::yap::expression, is_vector); // -
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(less, boost::yap::expression, is_vector); // <
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(greater, boost::yap::expression, is_vector); // >
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(less_equal, boost::yap::expression, is_vector); // <=
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(greater_equal, boost::yap::expression, is_vector); // >=
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(equal_to, boost::yap::expression, is_vector); // ==
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(not_equal_to, boost::yap::expression, is_vector); // !=
+
+//[ filter_mask
+// A selection of rows, one bit per row: row i is selected iff bit i % 64 of
+// words[i / 64] is set.  Bits past size are always zero.
+struct mask
+{
+    std::size_t count () const
+    {
+        std::size_t retval = 0;
+        for (std::uint64_t word : words) {
+            retval += __builtin_popcountll(word);
+        }
+        return retval;
+    }
+
+    std::vector<std::uint64_t> words;
+    std::size_t size;
+};
+
+// Evaluates the boolean expression expr for each of the first size rows, and
+// packs the results into a mask.  Each result is shifted into place rather
+// than branched on, so the inner loop has no data-dependent branches.
+template <typename Expr>
+mask make_mask (Expr const & expr, std::size_t size)
+{
+    mask retval{std::vector<std::uint64_t>((size + 63) / 64), size};
+    for (std::size_t w = 0; w < retval.words.size(); ++w) {
+        std::size_t const first = w * 64;
+        std::size_t const last = std::min(first + 64, size);
+        std::uint64_t word = 0;
+        for (std::size_t i = first; i < last; ++i) {
+            bool const selected = boost::yap::evaluate(boost::yap::transform(expr, take_nth{i}));
+            word |= std::uint64_t(selected) << (i - first);
+        }
+        retval.words[w] = word;
+    }
+    return retval;
+}
+//]
+
+//[ filter_compress
+// Returns the rows of column selected by m, in order.  A full word is copied
+// as one contiguous block; otherwise only the set bits are visited, lowest
+// first, so the cost is proportional to the number of selected rows rather
+// than to the number of rows.
+template <typename T>
+std::vector<T> compress (mask const & m, std::vector<T> const & column)
+{
+    assert(column.size() == m.size);
+    std::vector<T> retval(m.count());
+    auto out = retval.begin();
+    for (std::size_t w = 0; w < m.words.size(); ++w) {
+        std::uint64_t word = m.words[w];
+        auto const first = column.begin() + w * 64;
+        if (word == ~std::uint64_t(0)) {
+            out = std::copy(first, first + 64, out);
+            continue;
+        }
+        while (word) {
+            *out++ = first[__builtin_ctzll(word)];
+            word &= word - 1;
+        }
+    }
+    return retval;
+}
+
+// Returns the rows of each column selected by m, as a tuple of vectors.
+template <typename ...T>
+auto where (mask const & m, std::vector<T> const & ... columns)
+{ return std::make_tuple(compress(m, columns)...); }
+
+// Evaluates the boolean expression expr once into a mask, then returns the
+// rows of each column that it selects.
+template <typename Expr, typename ...T>
+auto where (Expr const & expr, std::vector<T> const & ... columns)
+{
+    static_assert(sizeof...(T) > 0, "where() needs at least one column.");
+    std::size_t const sizes[] = {columns.size()...};
+    assert(std::all_of(std::begin(sizes), std::end(sizes), [&](std::size_t s) {
+        return s == sizes[0];
+    }));
+    return where(make_mask(boost::yap::as_expr(expr), sizes[0]), columns...);
+}
+//]
+
+int main ()
+{
+    std::vector<int> id;
+    std::vector<double> price;
+    std::vector<double> cost;
+
+    for (int i = 0; i < 200; ++i) {
+        id.push_back(i);
+        price.push_back(10.0 + i % 7);
+        cost.push_back(8.0 + i % 5);
+    }
+
+    // Select the rows whose margin is more than 3; then pick out the ids and
+    // prices of those rows.
+    mask const selection = make_mask(price - cost > 3.0, id.size());
+    std::cout << selection.count() << " of " << selection.size << " rows selected\n";
+
+    std::vector<int> selected_ids;
+    std::vector<double> selected_prices;
+    std::tie(selected_ids, selected_prices) = where(selection, id, price);
+    for (std::size_t i = 0; i < 5; ++i) {
+        std::cout << "id=" << selected_ids[i] << " price=" << selected_prices[i] << "\n";
+    }
+
+    // The same thing, in one step.
+    auto const cheap = where(price <= 11.0, id, cost);
+    std::cout << std::get<0>(cheap).size() << " cheap rows; the first has cost "
+              << std::get<1>(cheap)[0] << "\n";
+
+    return 0;
+}
+//]
@@ -0,0 +1,196 @@
+//[ gather
+#include <boost/yap/yap.hpp>
+
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <random>
+#include <vector>
+
+
+// Define a type trait that identifies std::vectors.
+template <typename T>
+struct is_vector : std::false_type {};
+
+template <typename T, typename A>
+struct is_vector<std::vector<T, A>> : std::true_type {};
+
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(multiplies, boost::yap::expression, is_vector); // *
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(plus, boost::yap::expression, is_vector); // +
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(minus, boost::yap::expression, is_vector); // -
+
+
+//[ gather_bind
+// Each vector terminal is reduced, once, to a pointer to its first element.
+template <typename T>
+struct base_pointer
+{
+    T const * ptr;
+};
+
+struct bind_pointers
+{
+    template <typename T>
+    auto operator() (boost::yap::terminal_tag, std::vector<T> const & vec)
+    { return boost::yap::make_terminal(base_pointer<T>{vec.data()}); }
+};
+
+// Evaluates the bound expression at index i.  Each pointer is read at i, and
+// each operation is applied directly to the values of its operands, so no
+// expression is built, only a value computed.
+struct element_at
+{
+    template <typename T>
+    T operator() (boost::yap::terminal_tag, base_pointer<T> const & p) const
+    { return p.ptr[i]; }
+
+    template <typename T>
+    T operator() (boost::yap::terminal_tag, T const & value) const
+    { return value; }
+
+    template <typename L, typename R>
+    static auto apply (boost::yap::multiplies_tag, L l, R r) { return l * r; }
+    template <typename L, typename R>
+    static auto apply (boost::yap::plus_tag, L l, R r) { return l + r; }
+    template <typename L, typename R>
+    static auto apply (boost::yap::minus_tag, L l, R r) { return l - r; }
+
+    template <typename Tag, typename LExpr, typename RExpr>
+    auto operator() (Tag tag, LExpr const & lhs, RExpr const & rhs) const
+    { return apply(tag, boost::yap::transform(lhs, *this), boost::yap::transform(rhs, *this)); }
+
+    std::size_t i;
+};
+
+inline void prefetch (void const * ptr)
+{
+#if defined(__GNUC__)
+    __builtin_prefetch(ptr);
+#else
+    (void)ptr;
+#endif
+}
+
+// Issues a prefetch of element i of each operand.
+struct prefetch_operands
+{
+    template <typename Expr>
+    auto operator() (std::size_t i, Expr const & expr) ->
+        decltype(boost::yap::value(expr).ptr, std::size_t())
+    {
+        prefetch(boost::yap::value(expr).ptr + i);
+        return i;
+    }
+};
+//]
+
+
+//[ gather_evaluate
+struct gather_options
+{
+    // How many indices ahead of the one being evaluated to prefetch.  It
+    // should be large enough to cover a miss to memory, and small enough that
+    // the prefetched lines are still in cache when they are used.  0 turns
+    // prefetching off.
+    //
+    // The lookups here are independent of one another, so an out-of-order
+    // core already overlaps their misses, and for an expression as short as
+    // the one in main(), prefetching gains nothing measurable.  It pays off
+    // when the work per index is long enough to fill the core's reorder
+    // window, so that the next index's loads would otherwise start late.
+    std::size_t prefetch_distance = 16;
+};
+
+// Evaluates expr at each of the count indices starting at indices, writing
+// the results to out.
+template <typename Expr, typename OutIter>
+OutIter evaluate_at (
+    Expr const & expr,
+    std::size_t const * indices,
+    std::size_t count,
+    OutIter out,
+    gather_options options = gather_options()
+) {
+    auto const bound = boost::yap::transform(boost::yap::as_expr(expr), bind_pointers{});
+    std::size_t const distance = options.prefetch_distance;
+
+    std::size_t k = 0;
+    if (distance) {
+        for (std::size_t j = 0; j < distance && j < count; ++j) {
+            boost::yap::fold(bound, indices[j], prefetch_operands{});
+        }
+        for (; k + distance < count; ++k, ++out) {
+            boost::yap::fold(bound, indices[k + distance], prefetch_operands{});
+            *out = boost::yap::transform(bound, element_at{indices[k]});
+        }
+    }
+    for (; k < count; ++k, ++out) {
+        *out = boost::yap::transform(bound, element_at{indices[k]});
+    }
+    return out;
+}
+//]
+
+
+struct take_nth
+{
+    template <typename T>
+    auto operator() (boost::yap::terminal_tag, std::vector<T> const & vec)
+    { return boost::yap::make_terminal(vec[n]); }
+
+    std::size_t n;
+};
+
+int main ()
+{
+    // Three 64 MiB vectors, larger than most last-level caches.
+    std::size_t const n = std::size_t(1) << 23;
+    std::size_t const lookups = 1000000;
+
+    std::vector<double> a(n);
+    std::vector<double> b(n);
+    std::vector<double> c(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        a[i] = double(i % 1000);
+        b[i] = double(i % 17);
+        c[i] = 0.5 * double(i % 3);
+    }
+
+    std::mt19937_64 engine(42);
+    std::uniform_int_distribution<std::size_t> dist(0, n - 1);
+    std::vector<std::size_t> indices(lookups);
+    for (std::size_t & i : indices) {
+        i = dist(engine);
+    }
+
+    using clock = std::chrono::steady_clock;
+    auto const ms_since = [](clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(clock::now() - start).count();
+    };
+
+    auto expr = a * b + c - 1.0;
+
+    std::vector<double> expected(lookups);
+    clock::time_point start = clock::now();
+    for (std::size_t k = 0; k < lookups; ++k) {
+        expected[k] = boost::yap::evaluate(boost::yap::transform(expr, take_nth{indices[k]}));
+    }
+    std::cout << "take_nth per index: " << ms_since(start) << " ms\n";
+
+    std::vector<double> result(lookups);
+    gather_options no_prefetch;
+    no_prefetch.prefetch_distance = 0;
+    start = clock::now();
+    evaluate_at(expr, indices.data(), lookups, result.begin(), no_prefetch);
+    std::cout << "evaluate_at, no prefetch: " << ms_since(start) << " ms\n";
+    assert(result == expected);
+
+    start = clock::now();
+    evaluate_at(expr, indices.data(), lookups, result.begin());
+    std::cout << "evaluate_at, prefetch: " << ms_since(start) << " ms\n";
+    assert(result == expected);
+
+    return 0;
+}
+//]
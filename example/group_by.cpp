@@ -0,0 +1,409 @@
+//[ group_by
+#include <boost/yap/yap.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+
+struct take_nth
+{
+    template <typename T>
+    auto operator() (boost::yap::terminal_tag, std::vector<T> const & vec)
+    { return boost::yap::make_terminal(vec[n]); }
+
+    std::size_t n;
+};
+
+// Define a type trait that identifies std::vectors.
+template <typename T>
+struct is_vector : std::false_type {};
+
+template <typename T, typename A>
+struct is_vector<std::vector<T, A>> : std::true_type {};
+
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(multiplies, boost::yap::expression, is_vector); // *
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(divides, boost::yap::expression, is_vector); // /
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(modulus, boost::yap::expression, is_vector); // %
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(plus, boost::yap::expression, is_vector); // +
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(minus, boost::yap::expression, is_vector); // -
+
+// The value of expr at the given row.
+template <typename Expr>
+decltype(auto) eval_row (Expr const & expr, std::size_t row)
+{ return boost::yap::evaluate(boost::yap::transform(expr, take_nth{row})); }
+
+template <typename Expr>
+using row_value_t = std::decay_t<decltype(eval_row(std::declval<Expr const &>(), 0))>;
+
+// The number of rows in expr, taken from its first std::vector<> terminal.
+struct vector_size
+{
+    template <typename Expr>
+    auto operator() (std::size_t size, Expr const & expr) ->
+        decltype(boost::yap::value(expr).size())
+    { return size ? size : boost::yap::value(expr).size(); }
+};
+
+// True iff every std::vector<> terminal that the running value is folded
+// over has size elements.
+struct sizes_match
+{
+    template <typename Expr>
+    auto operator() (bool match, Expr const & expr) ->
+        decltype(boost::yap::value(expr).size(), bool())
+    { return match && boost::yap::value(expr).size() == size; }
+
+    std::size_t size;
+};
+
+template <typename Expr>
+std::size_t row_count (Expr const & expr)
+{ return boost::yap::fold(expr, std::size_t(0), vector_size{}); }
+
+
+//[ group_by_aggregates
+// Each aggregate has an initial state, folds one row at a time into a state,
+// and merges two states computed over disjoint sets of rows.
+template <typename Expr>
+struct sum_aggregate
+{
+    using state_type = row_value_t<Expr>;
+
+    state_type initial () const { return state_type(0); }
+    void update (state_type & state, std::size_t row) const { state += eval_row(expr, row); }
+    void merge (state_type & state, state_type const & other) const { state += other; }
+
+    Expr expr;
+};
+
+template <typename Expr>
+struct max_aggregate
+{
+    using state_type = row_value_t<Expr>;
+
+    state_type initial () const { return std::numeric_limits<state_type>::lowest(); }
+    void update (state_type & state, std::size_t row) const { state = std::max<state_type>(state, eval_row(expr, row)); }
+    void merge (state_type & state, state_type const & other) const { state = std::max(state, other); }
+
+    Expr expr;
+};
+
+struct count_aggregate
+{
+    using state_type = std::size_t;
+
+    state_type initial () const { return 0; }
+    void update (state_type & state, std::size_t) const { ++state; }
+    void merge (state_type & state, state_type const & other) const { state += other; }
+};
+
+template <typename Expr>
+auto sum (Expr && expr)
+{
+    using expr_type = std::decay_t<decltype(boost::yap::as_expr(static_cast<Expr &&>(expr)))>;
+    return sum_aggregate<expr_type>{boost::yap::as_expr(static_cast<Expr &&>(expr))};
+}
+
+template <typename Expr>
+auto max (Expr && expr)
+{
+    using expr_type = std::decay_t<decltype(boost::yap::as_expr(static_cast<Expr &&>(expr)))>;
+    return max_aggregate<expr_type>{boost::yap::as_expr(static_cast<Expr &&>(expr))};
+}
+
+inline count_aggregate count ()
+{ return count_aggregate{}; }
+
+// True iff every column that aggregate reads has rows elements.
+template <typename Aggregate>
+auto rows_match (Aggregate const & aggregate, std::size_t rows) ->
+    decltype((void)aggregate.expr, bool())
+{ return boost::yap::fold(aggregate.expr, true, sizes_match{rows}); }
+
+inline bool rows_match (count_aggregate const &, std::size_t)
+{ return true; }
+//]
+
+
+//[ group_by_hash_table
+// An open-addressing hash table with linear probing.  Slots live in flat
+// arrays, so there is no allocation per key.  Probing only touches the
+// compact array of hashes until a hash matches; a stored hash of zero marks
+// an empty slot.  The hashes are kept so that growing the table does not
+// rehash.
+template <typename Key, typename States>
+struct hash_table
+{
+    hash_table () : hashes_ (16), keys_ (16), states_ (16), size_ (0) {}
+
+    // Returns the states for key, inserting initial first if key is new.
+    States & find_or_insert (Key const & key, std::uint64_t hash, States const & initial)
+    {
+        hash |= 1;
+        std::size_t i = probe(key, hash);
+        if (!hashes_[i]) {
+            if (hashes_.size() < 2 * (size_ + 1)) {
+                grow();
+                i = probe(key, hash);
+            }
+            hashes_[i] = hash;
+            keys_[i] = key;
+            states_[i] = initial;
+            ++size_;
+        }
+        return states_[i];
+    }
+
+    template <typename F>
+    void for_each (F f) const
+    {
+        for (std::size_t i = 0; i < hashes_.size(); ++i) {
+            if (hashes_[i])
+                f(keys_[i], hashes_[i], states_[i]);
+        }
+    }
+
+private:
+    std::size_t probe (Key const & key, std::uint64_t hash) const
+    {
+        std::size_t const mask = hashes_.size() - 1;
+        std::size_t i = hash & mask;
+        while (hashes_[i] && !(hashes_[i] == hash && keys_[i] == key)) {
+            i = (i + 1) & mask;
+        }
+        return i;
+    }
+
+    void grow ()
+    {
+        hash_table old;
+        old.hashes_.resize(hashes_.size() * 2);
+        old.keys_.resize(hashes_.size() * 2);
+        old.states_.resize(hashes_.size() * 2);
+        swap(old.hashes_, hashes_);
+        swap(old.keys_, keys_);
+        swap(old.states_, states_);
+        for (std::size_t i = 0; i < old.hashes_.size(); ++i) {
+            if (old.hashes_[i]) {
+                std::size_t const j = probe(old.keys_[i], old.hashes_[i]);
+                hashes_[j] = old.hashes_[i];
+                keys_[j] = std::move(old.keys_[i]);
+                states_[j] = std::move(old.states_[i]);
+            }
+        }
+    }
+
+    std::vector<std::uint64_t> hashes_;
+    std::vector<Key> keys_;
+    std::vector<States> states_;
+    std::size_t size_;
+};
+//]
+
+// Mixes the bits of std::hash<>'s result, which is the identity for integers
+// on common implementations.
+template <typename Key>
+std::uint64_t hash_key (Key const & key)
+{
+    std::uint64_t h = std::hash<Key>{}(key);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return h;
+}
+
+
+//[ group_by_aggregate
+template <typename KeyExpr>
+struct grouping
+{
+    // Evaluates the key expression and every aggregate's expression in one
+    // pass over the rows, and returns one (key, states) pair per distinct key,
+    // in no particular order.
+    //
+    // With one thread, or too few rows to be worth splitting, the rows are
+    // aggregated into a single table, which is returned as it is.
+    //
+    // Otherwise, each of num_threads threads aggregates a contiguous range of
+    // rows into its own tables, one per partition; a key's partition is
+    // chosen by the high bits of its hash.  Then each thread merges the other
+    // threads' tables for one partition into the first thread's.  No table is
+    // shared by two threads at once.
+    template <typename ...Aggregates>
+    auto aggregate (Aggregates const & ... aggregates) const
+    {
+        using key_type = row_value_t<KeyExpr>;
+        using states_type = std::tuple<typename Aggregates::state_type...>;
+        using table_type = hash_table<key_type, states_type>;
+        using result_type = std::vector<std::pair<key_type, states_type>>;
+
+        std::size_t const rows = row_count(key_expr);
+        assert(boost::yap::fold(key_expr, true, sizes_match{rows}));
+        assert((rows_match(aggregates, rows) && ...));
+        std::size_t const partitions =
+            std::max(1u, std::min(num_threads, unsigned(rows / 4096 + 1)));
+        states_type const initial{aggregates.initial()...};
+
+        // Aggregates the rows [first, last) into table_for(hash of each key).
+        auto const aggregate_rows = [&](std::size_t first, std::size_t last, auto table_for) {
+            // A local copy of the key expression, which the compiler can see
+            // is not written to by the updates.
+            KeyExpr const key_e = key_expr;
+            for (std::size_t row = first; row < last; ++row) {
+                key_type const key = eval_row(key_e, row);
+                std::uint64_t const hash = hash_key(key);
+                states_type & states = table_for(hash).find_or_insert(key, hash, initial);
+                update(states, row, std::index_sequence_for<Aggregates...>{}, aggregates...);
+            }
+        };
+
+        result_type retval;
+        auto const append = [](result_type & result, table_type const & table) {
+            table.for_each([&](key_type const & key, std::uint64_t, states_type const & states) {
+                result.emplace_back(key, states);
+            });
+        };
+
+        if (partitions == 1) {
+            table_type table;
+            aggregate_rows(0, rows, [&](std::uint64_t) -> table_type & { return table; });
+            append(retval, table);
+            return retval;
+        }
+
+        auto const partition_of = [partitions](std::uint64_t hash) {
+            return std::size_t((hash >> 32) * partitions >> 32);
+        };
+
+        std::vector<std::vector<table_type>> local_tables(
+            partitions, std::vector<table_type>(partitions));
+        run_in_parallel(partitions, [&](std::size_t t) {
+            std::vector<table_type> & tables = local_tables[t];
+            aggregate_rows(
+                rows * t / partitions, rows * (t + 1) / partitions,
+                [&](std::uint64_t hash) -> table_type & { return tables[partition_of(hash)]; }
+            );
+        });
+
+        std::vector<result_type> results(partitions);
+        run_in_parallel(partitions, [&](std::size_t p) {
+            table_type & merged = local_tables[0][p];
+            for (std::size_t t = 1; t < partitions; ++t) {
+                local_tables[t][p].for_each([&](key_type const & key, std::uint64_t hash, states_type const & states) {
+                    merge(
+                        merged.find_or_insert(key, hash, initial), states,
+                        std::index_sequence_for<Aggregates...>{}, aggregates...
+                    );
+                });
+            }
+            append(results[p], merged);
+        });
+
+        for (auto & partition : results) {
+            retval.insert(retval.end(), partition.begin(), partition.end());
+        }
+        return retval;
+    }
+
+    KeyExpr key_expr;
+    unsigned num_threads;
+
+private:
+    template <typename States, std::size_t ...I, typename ...Aggregates>
+    static void update (States & states, std::size_t row, std::index_sequence<I...>, Aggregates const & ... aggregates)
+    {
+        int dummy[] = {0, (aggregates.update(std::get<I>(states), row), 0)...};
+        (void)dummy;
+    }
+
+    template <typename States, std::size_t ...I, typename ...Aggregates>
+    static void merge (States & states, States const & other, std::index_sequence<I...>, Aggregates const & ... aggregates)
+    {
+        int dummy[] = {0, (aggregates.merge(std::get<I>(states), std::get<I>(other)), 0)...};
+        (void)dummy;
+    }
+
+    template <typename F>
+    static void run_in_parallel (std::size_t n, F f)
+    {
+        std::vector<std::thread> threads;
+        for (std::size_t i = 1; i < n; ++i) {
+            threads.emplace_back(f, i);
+        }
+        f(0);
+        for (auto & thread : threads) {
+            thread.join();
+        }
+    }
+};
+
+template <typename Expr>
+auto group_by (Expr && key_expr, unsigned num_threads = std::thread::hardware_concurrency())
+{
+    using expr_type = std::decay_t<decltype(boost::yap::as_expr(static_cast<Expr &&>(key_expr)))>;
+    return grouping<expr_type>{
+        boost::yap::as_expr(static_cast<Expr &&>(key_expr)),
+        std::max(num_threads, 1u)
+    };
+}
+//]
+
+int main ()
+{
+    std::vector<int> customer;
+    std::vector<double> price;
+    std::vector<double> quantity;
+
+    for (int i = 0; i < 100000; ++i) {
+        customer.push_back(i * 7 % 1000);
+        price.push_back(1.0 + i % 13);
+        quantity.push_back(1.0 + i % 3);
+    }
+
+    // Total revenue, order count and largest single order, per group of ten
+    // customers.
+    auto groups = group_by(customer / 10).aggregate(
+        sum(price * quantity),
+        count(),
+        max(price * quantity)
+    );
+    std::sort(groups.begin(), groups.end(), [](auto const & lhs, auto const & rhs) {
+        return lhs.first < rhs.first;
+    });
+
+    std::cout << groups.size() << " groups\n";
+    for (std::size_t i = 0; i < 3; ++i) {
+        std::cout << "group " << groups[i].first
+                  << ": revenue=" << std::get<0>(groups[i].second)
+                  << " orders=" << std::get<1>(groups[i].second)
+                  << " largest=" << std::get<2>(groups[i].second) << "\n";
+    }
+
+    // Splitting the rows among four threads gives the same groups.
+    auto parallel_groups = group_by(customer / 10, 4).aggregate(
+        sum(price * quantity),
+        count(),
+        max(price * quantity)
+    );
+    std::sort(parallel_groups.begin(), parallel_groups.end(), [](auto const & lhs, auto const & rhs) {
+        return lhs.first < rhs.first;
+    });
+    assert(parallel_groups == groups);
+
+    std::size_t total = 0;
+    for (auto const & group : groups) {
+        total += std::get<1>(group.second);
+    }
+    assert(total == customer.size());
+    (void)total;
+
+    return 0;
+}
+//]
@@ -0,0 +1,194 @@
+//[ lanes
+#include <boost/yap/yap.hpp>
+
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <initializer_list>
+#include <iostream>
+#include <utility>
+
+
+//[ lanes_eval
+// The number of lanes in a value: N for a std::array<T, N>, and 0 for
+// anything else, such as a scalar that is broadcast to every lane.
+template <typename T>
+struct lane_count : std::integral_constant<std::size_t, 0> {};
+
+template <typename T, std::size_t N>
+struct lane_count<std::array<T, N>> : std::integral_constant<std::size_t, N> {};
+
+constexpr std::size_t max_of (std::initializer_list<std::size_t> counts)
+{
+    std::size_t retval = 0;
+    for (std::size_t count : counts) {
+        retval = retval < count ? count : retval;
+    }
+    return retval;
+}
+
+// True iff each of counts is either 0 or lanes.
+constexpr bool lane_counts_match (std::initializer_list<std::size_t> counts, std::size_t lanes)
+{
+    for (std::size_t count : counts) {
+        if (count != 0 && count != lanes)
+            return false;
+    }
+    return true;
+}
+
+template <std::size_t I, typename T, std::size_t N>
+T const & lane (std::array<T, N> const & a)
+{ return a[I]; }
+
+template <std::size_t I, typename T>
+T const & lane (T const & t)
+{ return t; }
+
+// Lane I of an operation: the operation applied to lane I of each operand.
+// The operands are scalars here, so this is just YAP's usual evaluation of
+// the operation.
+template <boost::yap::expr_kind Kind, std::size_t I, typename ...Operands>
+decltype(auto) lane_of_operation (Operands const & ... operands)
+{
+    return boost::yap::evaluate(
+        boost::yap::make_expression<boost::yap::expression, Kind>(
+            boost::yap::make_terminal(lane<I>(operands))...
+        )
+    );
+}
+
+template <boost::yap::expr_kind Kind, std::size_t ...I, typename ...Operands>
+auto all_lanes (std::index_sequence<I...>, Operands const & ... operands)
+{
+    using value_type = std::decay_t<decltype(lane_of_operation<Kind, 0>(operands...))>;
+    return std::array<value_type, sizeof...(I)>{{lane_of_operation<Kind, I>(operands...)...}};
+}
+
+// An operation on N lanes.  With no lanes, all the operands are scalars, and
+// so is the result.
+template <boost::yap::expr_kind Kind, typename ...Operands>
+auto lanes_of_operation (std::integral_constant<std::size_t, 0>, Operands const & ... operands)
+{ return lane_of_operation<Kind, 0>(operands...); }
+
+template <boost::yap::expr_kind Kind, std::size_t N, typename ...Operands>
+auto lanes_of_operation (std::integral_constant<std::size_t, N>, Operands const & ... operands)
+{ return all_lanes<Kind>(std::make_index_sequence<N>{}, operands...); }
+
+// Evaluates an expression over std::array<T, N> terminals into a
+// std::array<>, all lanes at a time.  Each operation is applied to its
+// evaluated operands by expanding a parameter pack over the lane indices, so
+// there is no loop to unroll: the result is a straight-line sequence of N
+// operations per node, which the compiler keeps in registers and packs into
+// SIMD instructions where it can.  Scalars are broadcast to every lane.
+struct evaluate_lanes_xform
+{
+    template <typename T>
+    T const & operator() (boost::yap::terminal_tag, T const & value) const
+    { return value; }
+
+    template <typename Expr>
+    auto evaluate_node (Expr const & expr) const
+    {
+        return boost::hana::unpack(expr.elements, [this](auto const & ... children) {
+            return evaluate_operands<Expr::kind>(boost::yap::transform(children, *this)...);
+        });
+    }
+
+    template <boost::yap::expr_kind Kind, typename ...Operands>
+    static auto evaluate_operands (Operands const & ... operands)
+    {
+        constexpr std::size_t lanes = max_of({lane_count<Operands>::value...});
+        static_assert(
+            lane_counts_match({lane_count<Operands>::value...}, lanes),
+            "All the array operands of an operation must have the same number of lanes."
+        );
+        return lanes_of_operation<Kind>(std::integral_constant<std::size_t, lanes>{}, operands...);
+    }
+
+    template <typename Expr>
+    auto operator() (Expr const & expr) const ->
+        std::enable_if_t<
+            Expr::kind != boost::yap::expr_kind::terminal &&
+            Expr::kind != boost::yap::expr_kind::expr_ref,
+            decltype(evaluate_node(expr))
+        >
+    { return evaluate_node(expr); }
+};
+
+template <typename Expr>
+auto evaluate_lanes (Expr const & expr)
+{ return boost::yap::transform(boost::yap::as_expr(expr), evaluate_lanes_xform{}); }
+//]
+
+
+//[ lanes_vec
+// A small fixed-size vector, like vec3 in the Vec3 example, but assigned
+// from an expression in a single pass over all of its components.
+template <typename T, std::size_t N>
+struct vec :
+    boost::yap::expression<
+        boost::yap::expr_kind::terminal,
+        boost::hana::tuple<std::array<T, N>>
+    >
+{
+    vec ()
+    { boost::yap::value(*this) = std::array<T, N>{}; }
+
+    explicit vec (std::array<T, N> a)
+    { boost::yap::value(*this) = a; }
+
+    T & operator[] (std::ptrdiff_t i)
+    { return boost::yap::value(*this)[i]; }
+
+    T const & operator[] (std::ptrdiff_t i) const
+    { return boost::yap::value(*this)[i]; }
+
+    // The whole right-hand side is evaluated before any component is
+    // written, so *this may appear in it.
+    template <typename Expr>
+    vec & operator= (Expr const & expr)
+    {
+        boost::yap::value(*this) = evaluate_lanes(expr);
+        return *this;
+    }
+};
+//]
+
+struct sqrt_fn
+{
+    float operator() (float x) const { return std::sqrt(x); }
+};
+
+auto const sqrt_ = boost::yap::make_terminal(sqrt_fn{});
+
+int main ()
+{
+    vec<float, 4> a;
+    vec<float, 4> b(std::array<float, 4>{{1.0f, 2.0f, 3.0f, 4.0f}});
+    vec<float, 4> c(std::array<float, 4>{{0.5f, 0.25f, 0.125f, 0.0625f}});
+
+    a = 2.0f * b + c - b * c;
+    for (int i = 0; i < 4; ++i) {
+        assert(a[i] == 2.0f * b[i] + c[i] - b[i] * c[i]);
+    }
+
+    // a appears on both sides.
+    a = sqrt_(a * a + 1.0f) - a;
+    std::cout << "a = {" << a[0] << ", " << a[1] << ", " << a[2] << ", " << a[3] << "}\n";
+
+    // A subexpression of scalars only is evaluated once, as a scalar.
+    a = b * (boost::yap::make_terminal(2.0f) + 1.0f);
+    for (int i = 0; i < 4; ++i) {
+        assert(a[i] == b[i] * 3.0f);
+    }
+
+    vec<int, 3> p(std::array<int, 3>{{1, 2, 3}});
+    vec<int, 3> q(std::array<int, 3>{{4, 5, 6}});
+    vec<int, 3> r;
+    r = (p + q) * 3 - q / p;
+    assert(r[0] == 11 && r[1] == 19 && r[2] == 25);
+
+    return 0;
+}
+//]
@@ -0,0 +1,361 @@
+//[ materialize
+#include <boost/yap/yap.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <deque>
+#include <initializer_list>
+#include <iostream>
+#include <map>
+#include <typeindex>
+#include <vector>
+
+
+//[ materialize_functions
+// Functions that may be called within expressions.  exp_fn is elementwise,
+// but costly.  sort_fn is not elementwise at all: it needs its whole
+// argument at once, and so can never be evaluated one element at a time.
+struct exp_fn
+{
+    double operator() (double x) const { return std::exp(x); }
+};
+
+struct sort_fn
+{
+    std::vector<double> operator() (std::vector<double> v) const
+    {
+        std::sort(v.begin(), v.end());
+        return v;
+    }
+};
+
+auto const exp_ = boost::yap::make_terminal(exp_fn{});
+auto const sort_ = boost::yap::make_terminal(sort_fn{});
+
+// The approximate cost of calling each kind of function once per element,
+// relative to that of an arithmetic operation.
+template <typename Fn>
+struct cost_hint : std::integral_constant<int, 1> {};
+
+template <>
+struct cost_hint<exp_fn> : std::integral_constant<int, 20> {};
+
+// Functions that take and return whole columns.
+template <typename Fn>
+struct is_whole_column : std::false_type {};
+
+template <>
+struct is_whole_column<sort_fn> : std::true_type {};
+//]
+
+// Define a type trait that identifies std::vectors.
+template <typename T>
+struct is_vector : std::false_type {};
+
+template <typename T, typename A>
+struct is_vector<std::vector<T, A>> : std::true_type {};
+
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(multiplies, boost::yap::expression, is_vector); // *
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(divides, boost::yap::expression, is_vector); // /
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(plus, boost::yap::expression, is_vector); // +
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(minus, boost::yap::expression, is_vector); // -
+
+
+//[ materialize_cost
+// The function called by expression Expr, if Expr is a call expression.
+template <typename Expr>
+using callee_t = std::decay_t<decltype(boost::yap::value(
+    boost::yap::get(std::declval<Expr const &>(), boost::hana::llong<0>{})
+))>;
+
+template <typename Expr, boost::yap::expr_kind Kind = std::decay_t<Expr>::kind>
+struct node_cost : std::integral_constant<int, 1> {};
+
+template <typename Expr>
+struct node_cost<Expr, boost::yap::expr_kind::call> : cost_hint<callee_t<Expr>> {};
+
+template <typename Expr, boost::yap::expr_kind Kind = std::decay_t<Expr>::kind>
+struct is_whole_column_call : std::false_type {};
+
+template <typename Expr>
+struct is_whole_column_call<Expr, boost::yap::expr_kind::call> : is_whole_column<callee_t<Expr>> {};
+
+constexpr int sum_of (std::initializer_list<int> costs)
+{
+    int retval = 0;
+    for (int cost : costs) {
+        retval += cost;
+    }
+    return retval;
+}
+
+// The cost of evaluating one element of Expr: the sum of the costs of its
+// nodes.
+template <typename Expr, boost::yap::expr_kind Kind = std::decay_t<Expr>::kind>
+struct subtree_cost;
+
+template <typename Tuple>
+struct children_cost;
+
+template <typename ...Children>
+struct children_cost<boost::hana::tuple<Children...>> :
+    std::integral_constant<int, sum_of({0, subtree_cost<Children>::value...})>
+{};
+
+template <typename Expr, boost::yap::expr_kind Kind>
+struct subtree_cost :
+    std::integral_constant<int, node_cost<Expr>::value + children_cost<decltype(std::decay_t<Expr>::elements)>::value>
+{};
+
+template <typename Expr>
+struct subtree_cost<Expr, boost::yap::expr_kind::terminal> : std::integral_constant<int, 0> {};
+
+template <typename Expr>
+struct subtree_cost<Expr, boost::yap::expr_kind::expr_ref> :
+    subtree_cost<decltype(boost::yap::deref(std::declval<Expr>()))>
+{};
+
+// Per element, a temporary costs about one store and one later load.
+constexpr int temporary_cost = 2;
+//]
+
+
+//[ materialize_plan
+// Identifies a subexpression by its type and the addresses of its terminals'
+// values, so that two occurrences of the same subexpression over the same
+// data have the same key.  Values of empty types, such as stateless function
+// objects, are all alike, so their addresses are left out.
+using subtree_key = std::pair<std::type_index, std::vector<void const *>>;
+
+struct terminal_addresses
+{
+    template <typename Expr>
+    auto operator() (std::vector<void const *> * addresses, Expr const & expr) ->
+        std::enable_if_t<Expr::kind == boost::yap::expr_kind::terminal, std::vector<void const *> *>
+    {
+        using value_type = std::decay_t<decltype(boost::yap::value(expr))>;
+        if (!std::is_empty<value_type>::value)
+            addresses->push_back(std::addressof(boost::yap::value(expr)));
+        return addresses;
+    }
+};
+
+template <typename Expr>
+subtree_key key_of (Expr const & expr)
+{
+    subtree_key retval{typeid(Expr), {}};
+    boost::yap::fold(expr, &retval.second, terminal_addresses{});
+    return retval;
+}
+
+struct plan
+{
+    std::map<subtree_key, int> counts;
+    std::map<subtree_key, std::vector<double> const *> materialized;
+    std::deque<std::vector<double>> temporaries;
+};
+
+// Counts the occurrences of each non-terminal subexpression.
+struct count_subtrees
+{
+    template <typename Expr>
+    auto operator() (plan * p, Expr const & expr) ->
+        std::enable_if_t<Expr::kind != boost::yap::expr_kind::terminal, plan *>
+    {
+        ++p->counts[key_of(expr)];
+        return p;
+    }
+};
+//]
+
+
+//[ materialize_cached
+// A subexpression that is evaluated once per element, unless values points
+// to its already-materialized values.
+template <typename Expr>
+struct cached
+{
+    std::size_t size () const;
+
+    std::vector<double> const * values;
+    Expr expr;
+};
+
+// The number of elements in expr, taken from its std::vector<> and cached<>
+// terminals.
+struct vector_size
+{
+    template <typename Expr>
+    auto operator() (std::size_t size, Expr const & expr) ->
+        decltype(boost::yap::value(expr).size())
+    { return std::max(size, boost::yap::value(expr).size()); }
+};
+
+template <typename Expr>
+std::size_t row_count (Expr const & expr)
+{ return boost::yap::fold(expr, std::size_t(0), vector_size{}); }
+
+template <typename Expr>
+std::size_t cached<Expr>::size () const
+{ return values ? values->size() : row_count(expr); }
+
+struct take_nth
+{
+    template <typename T>
+    auto operator() (boost::yap::terminal_tag, std::vector<T> const & vec)
+    { return boost::yap::make_terminal(vec[n]); }
+
+    template <typename Expr>
+    auto operator() (boost::yap::terminal_tag, cached<Expr> const & c)
+    {
+        return boost::yap::make_terminal(
+            c.values ? (*c.values)[n] : double(boost::yap::evaluate(boost::yap::transform(c.expr, *this)))
+        );
+    }
+
+    std::size_t n;
+};
+
+// Evaluates expr elementwise, into a new vector.
+template <typename Expr>
+std::vector<double> evaluate_elementwise (Expr const & expr)
+{
+    std::vector<double> retval(row_count(expr));
+    for (std::size_t i = 0; i < retval.size(); ++i) {
+        retval[i] = boost::yap::evaluate(boost::yap::transform(expr, take_nth{i}));
+    }
+    return retval;
+}
+//]
+
+
+//[ materialize_planner
+// Rewrites an expression so that it can be evaluated elementwise.  Each
+// subexpression is planned bottom-up, and then:
+//
+// - A call to a whole-column function is materialized: its argument is
+//   evaluated into a temporary, the function is applied to the temporary,
+//   and the subexpression is replaced by the result.
+//
+// - A subexpression that costs more per element than a temporary is wrapped
+//   in cached<>.  If it occurs often enough that computing it once for every
+//   occurrence would cost more than a temporary, it is materialized, once,
+//   and every occurrence reads the same temporary.
+//
+// - Any other subexpression is left to be evaluated elementwise.
+struct planner
+{
+    // The same kind of expression, with each child planned.
+    template <typename Expr>
+    auto plan_children (Expr const & expr) const
+    {
+        return boost::hana::unpack(expr.elements, [this](auto const & ... children) {
+            return boost::yap::make_expression<boost::yap::expression, Expr::kind>(
+                boost::yap::transform(children, *this)...
+            );
+        });
+    }
+
+    template <typename Expr>
+    auto plan_node (Expr const & expr, std::true_type) const
+    {
+        auto const planned = plan_children(expr);
+        std::vector<double> const * & values = p.materialized[key_of(expr)];
+        if (!values) {
+            auto const & fn = boost::yap::value(boost::yap::get(planned, boost::hana::llong<0>{}));
+            p.temporaries.push_back(
+                fn(evaluate_elementwise(boost::yap::get(planned, boost::hana::llong<1>{})))
+            );
+            values = &p.temporaries.back();
+        }
+        return boost::yap::make_terminal(*values);
+    }
+
+    template <typename Expr>
+    auto plan_node (Expr const & expr, std::false_type) const
+    { return plan_node(expr, std::integral_constant<bool, (temporary_cost < subtree_cost<Expr>::value)>{}, 0); }
+
+    template <typename Expr>
+    auto plan_node (Expr const & expr, std::true_type, int) const
+    {
+        using planned_type = decltype(plan_children(expr));
+        cached<planned_type> retval{nullptr, plan_children(expr)};
+        subtree_key const key = key_of(expr);
+        int const recomputations = p.counts[key] - 1;
+        if (temporary_cost < subtree_cost<Expr>::value * recomputations) {
+            std::vector<double> const * & values = p.materialized[key];
+            if (!values) {
+                p.temporaries.push_back(evaluate_elementwise(retval.expr));
+                values = &p.temporaries.back();
+            }
+            retval.values = values;
+        }
+        return boost::yap::make_terminal(std::move(retval));
+    }
+
+    template <typename Expr>
+    auto plan_node (Expr const & expr, std::false_type, int) const
+    { return plan_children(expr); }
+
+    template <typename Expr>
+    auto operator() (Expr const & expr) const ->
+        std::enable_if_t<
+            Expr::kind != boost::yap::expr_kind::terminal &&
+            Expr::kind != boost::yap::expr_kind::expr_ref,
+            decltype(plan_node(expr, is_whole_column_call<Expr>{}))
+        >
+    { return plan_node(expr, is_whole_column_call<Expr>{}); }
+
+    plan & p;
+};
+
+// Assigns expr to vec.  Each subexpression that is worth materializing is
+// evaluated once, before the main loop.
+template <typename Expr>
+std::vector<double> & assign (std::vector<double> & vec, Expr const & e)
+{
+    decltype(auto) expr = boost::yap::as_expr(e);
+    plan p;
+    boost::yap::fold(expr, &p, count_subtrees{});
+    auto const planned = boost::yap::transform(expr, planner{p});
+    vec.resize(row_count(planned));
+    for (std::size_t i = 0; i < vec.size(); ++i) {
+        vec[i] = boost::yap::evaluate(boost::yap::transform(planned, take_nth{i}));
+    }
+    return vec;
+}
+//]
+
+int main ()
+{
+    std::size_t const n = 1000;
+
+    std::vector<double> x(n);
+    std::vector<double> y(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        x[i] = 0.001 * double(i);
+        y[i] = double((i * 7919) % n);
+    }
+
+    // exp_(x) occurs three times, and is materialized once; sort_(y) is
+    // materialized because it cannot be evaluated elementwise.
+    std::vector<double> result;
+    assign(result, exp_(x) * y + exp_(x) / (1.0 + exp_(x)) - sort_(y));
+
+    std::vector<double> const sorted_y = sort_fn{}(y);
+    for (std::size_t i = 0; i < n; ++i) {
+        double const e = std::exp(x[i]);
+        double const expected = e * y[i] + e / (1.0 + e) - sorted_y[i];
+        assert(std::abs(result[i] - expected) < 1e-9 * std::abs(expected) + 1e-12);
+        (void)expected;
+    }
+    std::cout << "result[1] = " << result[1] << "\n";
+
+    // Cheap subexpressions are not materialized, however often they occur.
+    assign(result, (x + y) * (x + y));
+    assert(result[3] == (x[3] + y[3]) * (x[3] + y[3]));
+
+    return 0;
+}
+//]
@@ -0,0 +1,311 @@
+//[ matrix_chain
+#include <boost/yap/yap.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+
+//[ matrix_chain_matrix
+// A dense, row-major matrix.  A column vector is a matrix with one column.
+struct matrix
+{
+    matrix (std::size_t rows_ = 0, std::size_t cols_ = 0, double value = 0.0) :
+        rows (rows_),
+        cols (cols_),
+        elements (rows_ * cols_, value)
+    {}
+
+    double operator() (std::size_t i, std::size_t j) const
+    { return elements[i * cols + j]; }
+    double & operator() (std::size_t i, std::size_t j)
+    { return elements[i * cols + j]; }
+
+    std::size_t rows;
+    std::size_t cols;
+    std::vector<double> elements;
+};
+//]
+
+// Define a type trait that identifies matrices.
+template <typename T>
+struct is_matrix : std::false_type {};
+
+template <>
+struct is_matrix<matrix> : std::true_type {};
+
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(multiplies, boost::yap::expression, is_matrix); // *
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(plus, boost::yap::expression, is_matrix); // +
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(minus, boost::yap::expression, is_matrix); // -
+
+
+//[ matrix_chain_kernels
+// Computes lhs * rhs.  A product with a single column is a matrix-vector
+// product, one dot product per row.  Otherwise, the product is computed in
+// blocks small enough that a block of each operand stays in cache, and the
+// innermost loop runs along rows of rhs and of the result, so that it can be
+// vectorized.
+inline matrix multiply (matrix const & lhs, matrix const & rhs)
+{
+    assert(lhs.cols == rhs.rows);
+    matrix retval(lhs.rows, rhs.cols);
+
+    if (rhs.cols == 1) {
+        for (std::size_t i = 0; i < lhs.rows; ++i) {
+            double const * row = &lhs.elements[i * lhs.cols];
+            double sum = 0.0;
+            for (std::size_t k = 0; k < lhs.cols; ++k) {
+                sum += row[k] * rhs.elements[k];
+            }
+            retval.elements[i] = sum;
+        }
+        return retval;
+    }
+
+    std::size_t const block = 64;
+    for (std::size_t i0 = 0; i0 < lhs.rows; i0 += block) {
+        std::size_t const i1 = std::min(i0 + block, lhs.rows);
+        for (std::size_t k0 = 0; k0 < lhs.cols; k0 += block) {
+            std::size_t const k1 = std::min(k0 + block, lhs.cols);
+            for (std::size_t j0 = 0; j0 < rhs.cols; j0 += block) {
+                std::size_t const j1 = std::min(j0 + block, rhs.cols);
+                for (std::size_t i = i0; i < i1; ++i) {
+                    double * out = &retval.elements[i * retval.cols];
+                    for (std::size_t k = k0; k < k1; ++k) {
+                        double const a = lhs(i, k);
+                        double const * row = &rhs.elements[k * rhs.cols];
+                        for (std::size_t j = j0; j < j1; ++j) {
+                            out[j] += a * row[j];
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return retval;
+}
+
+template <typename Op>
+matrix elementwise (matrix const & lhs, matrix const & rhs, Op op)
+{
+    assert(lhs.rows == rhs.rows && lhs.cols == rhs.cols);
+    matrix retval(lhs.rows, lhs.cols);
+    for (std::size_t i = 0; i < retval.elements.size(); ++i) {
+        retval.elements[i] = op(lhs.elements[i], rhs.elements[i]);
+    }
+    return retval;
+}
+//]
+
+
+//[ matrix_chain_order
+// The best order in which to multiply a chain of matrices with the given
+// dimensions: matrix i is dims[i] x dims[i + 1].  split[i][j] is the index
+// of the last matrix on the left side of the outermost product of matrices
+// i through j.  This is the classic O(n^3) dynamic program, with the cost of
+// multiplying an m x n matrix by an n x p one taken to be m * n * p.
+struct chain_order
+{
+    explicit chain_order (std::vector<std::size_t> const & dims)
+    {
+        std::size_t const n = dims.size() - 1;
+        std::vector<std::vector<double>> cost(n, std::vector<double>(n, 0.0));
+        split.assign(n, std::vector<std::size_t>(n, 0));
+        for (std::size_t length = 2; length <= n; ++length) {
+            for (std::size_t i = 0; i + length <= n; ++i) {
+                std::size_t const j = i + length - 1;
+                cost[i][j] = std::numeric_limits<double>::infinity();
+                for (std::size_t k = i; k < j; ++k) {
+                    double const c = cost[i][k] + cost[k + 1][j] +
+                        double(dims[i]) * double(dims[k + 1]) * double(dims[j + 1]);
+                    if (c < cost[i][j]) {
+                        cost[i][j] = c;
+                        split[i][j] = k;
+                    }
+                }
+            }
+        }
+    }
+
+    // The order as a string, such as "(0 (1 2))".
+    std::string to_string (std::size_t i, std::size_t j) const
+    {
+        if (i == j)
+            return std::to_string(i);
+        std::size_t const k = split[i][j];
+        return "(" + to_string(i, k) + " " + to_string(k + 1, j) + ")";
+    }
+
+    std::vector<std::vector<std::size_t>> split;
+};
+//]
+
+
+//[ matrix_chain_eval
+// Gathers the operands of a chain of multiplies nodes, left to right.
+// Terminals are used in place; any other operand is evaluated first, and the
+// result is kept in temporaries.
+template <typename Eval>
+struct chain
+{
+    void collect (matrix const & m)
+    { operands.push_back(&m); }
+
+    template <typename Expr>
+    void collect (Expr const & expr)
+    { collect(expr, std::integral_constant<boost::yap::expr_kind, Expr::kind>{}); }
+
+    template <typename Expr>
+    void collect (Expr const & expr, std::integral_constant<boost::yap::expr_kind, boost::yap::expr_kind::terminal>)
+    { collect(boost::yap::value(expr)); }
+
+    template <typename Expr>
+    void collect (Expr const & expr, std::integral_constant<boost::yap::expr_kind, boost::yap::expr_kind::expr_ref>)
+    { collect(boost::yap::deref(expr)); }
+
+    template <typename Expr>
+    void collect (Expr const & expr, std::integral_constant<boost::yap::expr_kind, boost::yap::expr_kind::multiplies>)
+    {
+        collect(boost::yap::left(expr));
+        collect(boost::yap::right(expr));
+    }
+
+    template <typename Expr, boost::yap::expr_kind Kind>
+    void collect (Expr const & expr, std::integral_constant<boost::yap::expr_kind, Kind>)
+    {
+        temporaries.push_back(boost::yap::transform(expr, eval));
+        operands.push_back(&temporaries.back());
+    }
+
+    chain_order order () const
+    {
+        std::vector<std::size_t> dims;
+        for (matrix const * m : operands) {
+            assert(dims.empty() || dims.back() == m->rows);
+            if (dims.empty())
+                dims.push_back(m->rows);
+            dims.push_back(m->cols);
+        }
+        return chain_order(dims);
+    }
+
+    // Multiplies operands i through j, in the given order.
+    matrix product (chain_order const & order, std::size_t i, std::size_t j) const
+    {
+        std::size_t const k = order.split[i][j];
+        matrix lhs_product;
+        matrix rhs_product;
+        matrix const & lhs = k == i ? *operands[i] : (lhs_product = product(order, i, k));
+        matrix const & rhs = k + 1 == j ? *operands[j] : (rhs_product = product(order, k + 1, j));
+        return multiply(lhs, rhs);
+    }
+
+    Eval eval;
+    std::vector<matrix const *> operands;
+    std::deque<matrix> temporaries;
+};
+
+// Evaluates an expression over matrices.  + and - are elementwise; a chain of
+// * is gathered in its entirety, and multiplied in the cheapest order.
+struct matrix_eval
+{
+    template <typename Expr1, typename Expr2>
+    matrix operator() (boost::yap::multiplies_tag, Expr1 const & expr1, Expr2 const & expr2) const
+    {
+        chain<matrix_eval> c{*this, {}, {}};
+        c.collect(expr1);
+        c.collect(expr2);
+        return c.product(c.order(), 0, c.operands.size() - 1);
+    }
+
+    template <typename Expr1, typename Expr2>
+    matrix operator() (boost::yap::plus_tag, Expr1 const & expr1, Expr2 const & expr2) const
+    {
+        return elementwise(
+            boost::yap::transform(expr1, *this),
+            boost::yap::transform(expr2, *this),
+            [](double x, double y) { return x + y; }
+        );
+    }
+
+    template <typename Expr1, typename Expr2>
+    matrix operator() (boost::yap::minus_tag, Expr1 const & expr1, Expr2 const & expr2) const
+    {
+        return elementwise(
+            boost::yap::transform(expr1, *this),
+            boost::yap::transform(expr2, *this),
+            [](double x, double y) { return x - y; }
+        );
+    }
+};
+
+template <typename Expr>
+matrix evaluate_matrix (Expr const & expr)
+{ return boost::yap::transform(boost::yap::as_expr(expr), matrix_eval{}); }
+
+// The order in which evaluate_matrix() would multiply the chain of products
+// at the top of expr.
+template <typename Expr>
+std::string chain_order_of (Expr const & expr)
+{
+    chain<matrix_eval> c{matrix_eval{}, {}, {}};
+    c.collect(expr);
+    return c.order().to_string(0, c.operands.size() - 1);
+}
+//]
+
+int main ()
+{
+    std::size_t const n = 400;
+
+    matrix a(n, n);
+    matrix b(n, n);
+    matrix v(n, 1);
+    for (std::size_t i = 0; i < n; ++i) {
+        v.elements[i] = 1.0 / double(i + 1);
+        for (std::size_t j = 0; j < n; ++j) {
+            a(i, j) = double((i + j) % 7) - 3.0;
+            b(i, j) = double((i * j) % 5) - 2.0;
+        }
+    }
+
+    using clock = std::chrono::steady_clock;
+    auto const ms_since = [](clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(clock::now() - start).count();
+    };
+
+    // A * B * v parses as (A * B) * v; it is evaluated as A * (B * v).
+    std::cout << "A * B * v is evaluated as " << chain_order_of(a * b * v) << "\n";
+    assert(chain_order_of(a * b * v) == "(0 (1 2))");
+
+    clock::time_point start = clock::now();
+    matrix const chosen = evaluate_matrix(a * b * v);
+    std::cout << "chosen order: " << ms_since(start) << " ms\n";
+
+    start = clock::now();
+    matrix const left_to_right = multiply(multiply(a, b), v);
+    std::cout << "left to right: " << ms_since(start) << " ms\n";
+
+    for (std::size_t i = 0; i < n; ++i) {
+        assert(std::abs(chosen.elements[i] - left_to_right.elements[i]) < 1e-9);
+    }
+
+    // Non-product operands are evaluated first, then take part in the chain.
+    matrix const sum = evaluate_matrix((a + b) * (a - b) * v);
+    matrix const expected = multiply(multiply(elementwise(a, b, std::plus<>()), elementwise(a, b, std::minus<>())), v);
+    for (std::size_t i = 0; i < n; ++i) {
+        assert(std::abs(sum.elements[i] - expected.elements[i]) < 1e-6);
+    }
+    (void)sum;
+    (void)expected;
+
+    return 0;
+}
+//]
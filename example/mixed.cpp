@@ -54,7 +54,8 @@ struct incr
 
 
 // The implementation of elementwise evaluation of expressions of sequences;
-// all the later operations use this one.
+// all the later operations use this one.  It transforms the expression twice
+// per element; zip.cpp does the same job with no per-element transforms.
 template <
     template <class, class> class Cont,
     typename T,
@@ -0,0 +1,174 @@
+//[ mixed_precision
+#include <boost/yap/yap.hpp>
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+
+//[ mixed_precision_bfloat16
+// A 16-bit floating point type with the exponent range of float and 8 bits
+// of significand: the upper half of a float, rounded to nearest even.  It
+// has no arithmetic of its own; it is only a storage format.
+struct bfloat16
+{
+    bfloat16 () = default;
+
+    explicit bfloat16 (float f)
+    {
+        std::uint32_t u;
+        std::memcpy(&u, &f, sizeof(u));
+        if (std::isnan(f))
+            bits = std::uint16_t((u >> 16) | 0x40);
+        else
+            bits = std::uint16_t((u + 0x7fff + ((u >> 16) & 1)) >> 16);
+    }
+
+    explicit operator float () const
+    {
+        std::uint32_t const u = std::uint32_t(bits) << 16;
+        float retval;
+        std::memcpy(&retval, &u, sizeof(retval));
+        return retval;
+    }
+
+    std::uint16_t bits;
+};
+//]
+
+// Define a type trait that identifies std::vectors.
+template <typename T>
+struct is_vector : std::false_type {};
+
+template <typename T, typename A>
+struct is_vector<std::vector<T, A>> : std::true_type {};
+
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(multiplies, boost::yap::expression, is_vector); // *
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(divides, boost::yap::expression, is_vector); // /
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(plus, boost::yap::expression, is_vector); // +
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(minus, boost::yap::expression, is_vector); // -
+
+
+//[ mixed_precision_policy
+// The precision in which an expression is evaluated.  Elements are converted
+// from their storage types to Compute as they are read, all the arithmetic
+// is done in Compute, and results are converted back to the storage type of
+// the destination as they are written.  Reductions accumulate in Accumulate.
+template <typename Compute, typename Accumulate = Compute>
+struct precision
+{
+    using compute_type = Compute;
+    using accumulate_type = Accumulate;
+};
+
+template <typename To, typename From>
+To convert (From x)
+{ return static_cast<To>(x); }
+
+// bfloat16 converts explicitly only to float.
+template <typename To>
+To convert (bfloat16 x)
+{ return static_cast<To>(static_cast<float>(x)); }
+//]
+
+
+//[ mixed_precision_evaluate
+// Element n of an expression, with every vector element and scalar
+// converted to Compute.
+template <typename Compute>
+struct take_nth_as
+{
+    template <typename T>
+    auto operator() (boost::yap::terminal_tag, std::vector<T> const & vec)
+    { return boost::yap::make_terminal(convert<Compute>(vec[n])); }
+
+    template <typename T>
+    auto operator() (boost::yap::terminal_tag, T const & value) ->
+        std::enable_if_t<std::is_arithmetic<T>::value, decltype(boost::yap::make_terminal(Compute()))>
+    { return boost::yap::make_terminal(convert<Compute>(value)); }
+
+    std::size_t n;
+};
+
+template <typename Policy, typename Expr>
+typename Policy::compute_type evaluate_nth (Expr const & expr, std::size_t n)
+{
+    using compute_type = typename Policy::compute_type;
+    return boost::yap::evaluate(boost::yap::transform(boost::yap::as_expr(expr), take_nth_as<compute_type>{n}));
+}
+
+// True iff every std::vector<> terminal that the running value is folded
+// over has size elements.
+struct sizes_match
+{
+    template <typename Expr>
+    auto operator() (bool match, Expr const & expr) ->
+        decltype(boost::yap::value(expr).size(), bool())
+    { return match && boost::yap::value(expr).size() == size; }
+
+    std::size_t size;
+};
+
+// Assigns expr to vec, narrowing each element to T only when it is stored.
+template <typename Policy, typename T, typename Expr>
+std::vector<T> & assign (std::vector<T> & vec, Expr const & expr)
+{
+    assert(boost::yap::fold(boost::yap::as_expr(expr), true, sizes_match{vec.size()}));
+    for (std::size_t i = 0, size = vec.size(); i < size; ++i) {
+        vec[i] = convert<T>(evaluate_nth<Policy>(expr, i));
+    }
+    return vec;
+}
+
+// Returns the sum of the first size elements of expr, accumulated in
+// Policy::accumulate_type.
+template <typename Policy, typename Expr>
+typename Policy::accumulate_type sum (Expr const & expr, std::size_t size)
+{
+    using accumulate_type = typename Policy::accumulate_type;
+    accumulate_type retval = 0;
+    for (std::size_t i = 0; i < size; ++i) {
+        retval += convert<accumulate_type>(evaluate_nth<Policy>(expr, i));
+    }
+    return retval;
+}
+//]
+
+int main ()
+{
+    std::size_t const n = 1 << 20;
+
+    // Stored as float; half the bytes of double.
+    std::vector<float> big(n, 1.0e8f);
+    std::vector<float> small(n, 3.0f);
+    std::vector<float> result(n);
+
+    // In float, big + small rounds away small entirely, and the difference
+    // is zero.  In double, it is exact.
+    assign<precision<float>>(result, (big + small) - big);
+    assert(result[0] == 0.0f);
+    assign<precision<double>>(result, (big + small) - big);
+    assert(result[0] == 3.0f);
+
+    // Summing a million floats in a float accumulator is off by about 1%; in
+    // a double accumulator, the error is negligible.
+    std::vector<float> tenths(n, 0.1f);
+    float const float_sum = sum<precision<float>>(tenths * 1.0f, n);
+    double const double_sum = sum<precision<float, double>>(tenths * 1.0f, n);
+    std::cout << "sum in float: " << float_sum << "\n"
+              << "sum in double: " << double_sum << "\n";
+    assert(std::abs(double_sum - 0.1f * double(n)) < 1.0);
+    assert(1.0 < std::abs(float_sum - 0.1f * double(n)));
+
+    // bfloat16 storage, with float arithmetic.
+    std::vector<bfloat16> x(n, bfloat16(1.5f));
+    std::vector<bfloat16> y(n);
+    assign<precision<float>>(y, x * x + 0.25f);
+    assert(static_cast<float>(y[0]) == 2.5f);
+
+    return 0;
+}
+//]
@@ -0,0 +1,391 @@
+//[ mmap_column
+#include <boost/yap/yap.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstdio>
+#include <future>
+#include <iostream>
+#include <system_error>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+//[ mmap_column_file
+// A memory-mapped file.  It is mapped read-only, or, if it is created with a
+// size, read-write.
+class mapped_file
+{
+public:
+    explicit mapped_file (char const * path) :
+        fd_ (::open(path, O_RDONLY)),
+        addr_ (nullptr),
+        bytes_ (0)
+    {
+        check(fd_ != -1);
+        struct stat st;
+        check(::fstat(fd_, &st) == 0);
+        bytes_ = std::size_t(st.st_size);
+        map(PROT_READ);
+    }
+
+    mapped_file (char const * path, std::size_t bytes) :
+        fd_ (::open(path, O_RDWR | O_CREAT | O_TRUNC, 0644)),
+        addr_ (nullptr),
+        bytes_ (bytes)
+    {
+        check(fd_ != -1);
+        check(::ftruncate(fd_, off_t(bytes_)) == 0);
+        map(PROT_READ | PROT_WRITE);
+    }
+
+    mapped_file (mapped_file && other) :
+        fd_ (other.fd_),
+        addr_ (other.addr_),
+        bytes_ (other.bytes_)
+    {
+        other.fd_ = -1;
+        other.addr_ = nullptr;
+        other.bytes_ = 0;
+    }
+
+    mapped_file (mapped_file const &) = delete;
+    mapped_file & operator= (mapped_file const &) = delete;
+
+    ~mapped_file ()
+    {
+        if (addr_)
+            ::munmap(addr_, bytes_);
+        if (fd_ != -1)
+            ::close(fd_);
+    }
+
+    void * data () const { return addr_; }
+    std::size_t size () const { return bytes_; }
+
+    // Passes advice (one of the MADV_* constants) about the bytes [first,
+    // last) to the kernel.  Advice is only a hint, so failure is ignored.
+    // MADV_DONTNEED applies only to the pages entirely inside [first, last),
+    // since the pages at either end may be shared with neighbouring ranges
+    // that are still in use; other advice applies to every page that [first,
+    // last) touches.
+    void advise (std::size_t first, std::size_t last, int advice) const
+    {
+        std::size_t const page = std::size_t(::sysconf(_SC_PAGESIZE));
+        last = std::min(last, bytes_);
+        if (advice == MADV_DONTNEED) {
+            first = (first + page - 1) / page * page;
+            // The last page of the file is not shared with anything after it.
+            if (last != bytes_)
+                last = last / page * page;
+        } else {
+            first = first / page * page;
+        }
+        if (first < last)
+            ::madvise(static_cast<char *>(addr_) + first, last - first, advice);
+    }
+
+    // Starts writing the bytes [first, last) back to the file, without
+    // waiting for the writes to finish.
+    void flush (std::size_t first, std::size_t last) const
+    {
+        std::size_t const page = std::size_t(::sysconf(_SC_PAGESIZE));
+        first = first / page * page;
+        last = std::min(last, bytes_);
+        if (first < last)
+            ::msync(static_cast<char *>(addr_) + first, last - first, MS_ASYNC);
+    }
+
+    // Faults in the pages of the bytes [first, last), by reading one byte
+    // from each.
+    void touch (std::size_t first, std::size_t last) const
+    {
+        std::size_t const page = std::size_t(::sysconf(_SC_PAGESIZE));
+        last = std::min(last, bytes_);
+        char const volatile * bytes = static_cast<char const *>(addr_);
+        for (std::size_t i = first / page * page; i < last; i += page) {
+            (void)bytes[i];
+        }
+    }
+
+private:
+    void map (int prot)
+    {
+        if (!bytes_)
+            return;
+        addr_ = ::mmap(nullptr, bytes_, prot, MAP_SHARED, fd_, 0);
+        if (addr_ == MAP_FAILED) {
+            addr_ = nullptr;
+            check(false);
+        }
+    }
+
+    // Only called while constructing, so on failure it closes the file
+    // itself; the destructor of a partly constructed object never runs.
+    void check (bool ok)
+    {
+        if (ok)
+            return;
+        int const error = errno;
+        if (fd_ != -1)
+            ::close(fd_);
+        throw std::system_error(error, std::generic_category());
+    }
+
+    int fd_;
+    void * addr_;
+    std::size_t bytes_;
+};
+
+// A read-only column of fixed-width values, stored in a file.
+template <typename T>
+struct mapped_column
+{
+    explicit mapped_column (char const * path) : file (path) {}
+
+    T const * data () const { return static_cast<T const *>(file.data()); }
+    std::size_t size () const { return file.size() / sizeof(T); }
+
+    mapped_file file;
+};
+
+// A writable column of fixed-width values, stored in a file that is created
+// to hold exactly size values.
+template <typename T>
+struct mapped_output
+{
+    mapped_output (char const * path, std::size_t size) : file (path, size * sizeof(T)) {}
+
+    T * data () const { return static_cast<T *>(file.data()); }
+    std::size_t size () const { return file.size() / sizeof(T); }
+
+    mapped_file file;
+};
+//]
+
+struct take_nth
+{
+    template <typename T>
+    auto operator() (boost::yap::terminal_tag, std::vector<T> const & vec)
+    { return boost::yap::make_terminal(vec[n]); }
+
+    template <typename T>
+    auto operator() (boost::yap::terminal_tag, mapped_column<T> const & column)
+    { return boost::yap::make_terminal(column.data()[n]); }
+
+    std::size_t n;
+};
+
+// Define a type trait that identifies std::vectors and mapped_columns.
+template <typename T>
+struct is_column : std::false_type {};
+
+template <typename T, typename A>
+struct is_column<std::vector<T, A>> : std::true_type {};
+
+template <typename T>
+struct is_column<mapped_column<T>> : std::true_type {};
+
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(multiplies, boost::yap::expression, is_column); // *
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(divides, boost::yap::expression, is_column); // /
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(plus, boost::yap::expression, is_column); // +
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(minus, boost::yap::expression, is_column); // -
+
+template <typename Expr>
+decltype(auto) eval_row (Expr const & expr, std::size_t row)
+{ return boost::yap::evaluate(boost::yap::transform(expr, take_nth{row})); }
+
+template <typename Expr>
+using row_value_t = std::decay_t<decltype(eval_row(std::declval<Expr const &>(), 0))>;
+
+// The number of rows in expr, taken from its columns.
+struct column_size
+{
+    template <typename Expr>
+    auto operator() (std::size_t size, Expr const & expr) ->
+        decltype(boost::yap::value(expr).size())
+    { return std::max(size, boost::yap::value(expr).size()); }
+};
+
+// True iff every column terminal that the running value is folded over has
+// size elements.
+struct sizes_match
+{
+    template <typename Expr>
+    auto operator() (bool match, Expr const & expr) ->
+        decltype(boost::yap::value(expr).size(), bool())
+    { return match && boost::yap::value(expr).size() == size; }
+
+    std::size_t size;
+};
+
+
+//[ mmap_column_chunks
+// A mapped file in an expression, and the width of its rows in bytes.
+struct mapped_range
+{
+    mapped_file const * file;
+    std::size_t row_bytes;
+};
+
+struct collect_mapped_files
+{
+    template <typename Expr>
+    auto operator() (std::vector<mapped_range> ranges, Expr const & expr) ->
+        decltype(boost::yap::value(expr).file, std::vector<mapped_range>())
+    {
+        auto const & column = boost::yap::value(expr);
+        ranges.push_back(mapped_range{&column.file, sizeof(*column.data())});
+        return ranges;
+    }
+};
+
+struct chunk_options
+{
+    std::size_t rows = std::size_t(1) << 20;
+    bool prefetch_on_thread = true;
+};
+
+// Calls f(first, last) for consecutive chunks of rows [first, last) of
+// expr, of at most options.rows rows each.
+//
+// The kernel is told that every mapped column is read sequentially.  While
+// f processes one chunk, the next chunk is requested with MADV_WILLNEED and,
+// if options.prefetch_on_thread is set, faulted in by a helper thread, so
+// that f rarely waits for the disk.  Once f is done with a chunk, its pages
+// are released with MADV_DONTNEED, so that a column larger than memory does
+// not push everything else out of it.
+template <typename Expr, typename F>
+void for_each_chunk (Expr const & expr, chunk_options const & options, F f)
+{
+    std::vector<mapped_range> const ranges =
+        boost::yap::fold(expr, std::vector<mapped_range>{}, collect_mapped_files{});
+    std::size_t const rows = boost::yap::fold(expr, std::size_t(0), column_size{});
+    assert(boost::yap::fold(expr, true, sizes_match{rows}));
+    std::size_t const chunk_rows = std::max(options.rows, std::size_t(1));
+
+    auto const advise = [&](std::size_t first, std::size_t last, int advice) {
+        for (mapped_range const & range : ranges) {
+            range.file->advise(first * range.row_bytes, last * range.row_bytes, advice);
+        }
+    };
+    auto const touch = [&](std::size_t first, std::size_t last) {
+        for (mapped_range const & range : ranges) {
+            range.file->touch(first * range.row_bytes, last * range.row_bytes);
+        }
+    };
+
+    advise(0, rows, MADV_SEQUENTIAL);
+    for (std::size_t first = 0; first < rows; first += chunk_rows) {
+        std::size_t const last = std::min(first + chunk_rows, rows);
+        std::size_t const next_last = std::min(last + chunk_rows, rows);
+        std::future<void> prefetch;
+        if (last < rows) {
+            advise(last, next_last, MADV_WILLNEED);
+            if (options.prefetch_on_thread && !ranges.empty())
+                prefetch = std::async(std::launch::async, touch, last, next_last);
+        }
+        f(first, last);
+        advise(first, last, MADV_DONTNEED);
+        if (prefetch.valid())
+            prefetch.get();
+    }
+}
+//]
+
+//[ mmap_column_consumers
+template <typename Expr>
+auto sum (Expr const & expr, chunk_options const & options = chunk_options())
+{
+    using value_type = row_value_t<Expr>;
+    value_type retval(0);
+    for_each_chunk(expr, options, [&](std::size_t first, std::size_t last) {
+        for (std::size_t i = first; i < last; ++i) {
+            retval += eval_row(expr, i);
+        }
+    });
+    return retval;
+}
+
+// Assigns expr to result.  Each chunk of the result is handed to the kernel
+// to write back as soon as it is complete.
+template <typename T, typename Expr>
+mapped_output<T> & assign (
+    mapped_output<T> & result,
+    Expr const & expr,
+    chunk_options const & options = chunk_options()
+) {
+    T * const out = result.data();
+    for_each_chunk(expr, options, [&](std::size_t first, std::size_t last) {
+        assert(last <= result.size());
+        for (std::size_t i = first; i < last; ++i) {
+            out[i] = eval_row(expr, i);
+        }
+        result.file.flush(first * sizeof(T), last * sizeof(T));
+    });
+    return result;
+}
+//]
+
+template <typename T>
+void write_file (char const * path, std::vector<T> const & values)
+{
+    std::FILE * f = std::fopen(path, "wb");
+    if (!f)
+        throw std::system_error(errno, std::generic_category(), path);
+    std::size_t const written = std::fwrite(values.data(), sizeof(T), values.size(), f);
+    int const error = errno;
+    std::fclose(f);
+    if (written != values.size())
+        throw std::system_error(error, std::generic_category(), path);
+}
+
+int main ()
+{
+    std::size_t const n = 1 << 20;
+
+    std::vector<double> price_values(n);
+    std::vector<double> quantity_values(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        price_values[i] = 1.0 + i % 13;
+        quantity_values[i] = 1.0 + i % 3;
+    }
+    write_file("mmap_column_price.bin", price_values);
+    write_file("mmap_column_quantity.bin", quantity_values);
+
+    {
+        mapped_column<double> const price("mmap_column_price.bin");
+        mapped_column<double> const quantity("mmap_column_quantity.bin");
+        std::vector<double> const discount(n, 0.5);
+
+        chunk_options options;
+        options.rows = 1 << 16;
+
+        double const revenue = sum(price * quantity - discount, options);
+        std::cout << "revenue = " << revenue << "\n";
+
+        mapped_output<double> totals("mmap_column_totals.bin", n);
+        assign(totals, price * quantity - discount, options);
+        std::cout << "totals(7) = " << totals.data()[7] << "\n";
+
+        double expected = 0.0;
+        for (std::size_t i = 0; i < n; ++i) {
+            expected += price_values[i] * quantity_values[i] - 0.5;
+            assert(totals.data()[i] == price_values[i] * quantity_values[i] - 0.5);
+        }
+        assert(revenue == expected);
+        (void)expected;
+    }
+
+    std::remove("mmap_column_price.bin");
+    std::remove("mmap_column_quantity.bin");
+    std::remove("mmap_column_totals.bin");
+
+    return 0;
+}
+//]
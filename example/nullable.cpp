@@ -0,0 +1,158 @@
+//[ nullable
+#include <boost/yap/yap.hpp>
+
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+
+//[ nullable_column
+// A column of T in which any row may be null.  Like an Arrow array, it is a
+// data buffer plus a validity bitmap: row i is valid iff bit i % 64 of
+// valid[i / 64] is set.  The data of a null row is unspecified, but is always
+// safe to compute with.
+template <typename T>
+struct nullable_column
+{
+    explicit nullable_column (std::size_t size = 0) :
+        data (size),
+        valid ((size + 63) / 64, ~std::uint64_t(0))
+    {
+        if (size % 64)
+            valid.back() = (std::uint64_t(1) << size % 64) - 1;
+    }
+
+    std::size_t size () const
+    { return data.size(); }
+
+    bool is_valid (std::size_t i) const
+    { return valid[i / 64] >> (i % 64) & 1; }
+
+    void set_null (std::size_t i)
+    { valid[i / 64] &= ~(std::uint64_t(1) << (i % 64)); }
+
+    std::vector<T> data;
+    std::vector<std::uint64_t> valid;
+};
+//]
+
+struct take_nth
+{
+    template <typename T>
+    auto operator() (boost::yap::terminal_tag, std::vector<T> const & vec)
+    { return boost::yap::make_terminal(vec[n]); }
+
+    template <typename T>
+    auto operator() (boost::yap::terminal_tag, nullable_column<T> const & column)
+    { return boost::yap::make_terminal(column.data[n]); }
+
+    std::size_t n;
+};
+
+// Define a type trait that identifies std::vectors and nullable_columns.
+template <typename T>
+struct is_column : std::false_type {};
+
+template <typename T, typename A>
+struct is_column<std::vector<T, A>> : std::true_type {};
+
+template <typename T>
+struct is_column<nullable_column<T>> : std::true_type {};
+
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(multiplies, boost::yap::expression, is_column); // *
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(divides, boost::yap::expression, is_column); // /
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(plus, boost::yap::expression, is_column); // +
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(minus, boost::yap::expression, is_column); // -
+
+//[ nullable_validity
+// Folds the validity of one 64-row word of each nullable_column terminal into
+// the running word.  It can only be called with nullable_column terminals;
+// every other node, including std::vector<> terminals, leaves the word
+// unchanged, since those rows are always valid.
+struct validity_word
+{
+    template <typename Expr>
+    auto operator() (std::uint64_t word, Expr const & expr) ->
+        decltype(word & boost::yap::value(expr).valid[0])
+    { return word & boost::yap::value(expr).valid[w]; }
+
+    std::size_t w;
+};
+
+// True iff every column terminal that the running value is folded over has
+// size elements.
+struct sizes_match
+{
+    template <typename Expr>
+    auto operator() (bool match, Expr const & expr) ->
+        decltype(boost::yap::value(expr).size(), bool())
+    { return match && boost::yap::value(expr).size() == size; }
+
+    std::size_t size;
+};
+//]
+
+//[ nullable_assign
+// Assigns expression expr to result.  The data of every row is computed
+// unconditionally, with no per-row test of validity, so the loop is free to
+// vectorize.  Then each word of the result's validity is the bitwise and of
+// the corresponding words of all the nullable operands.
+template <typename T, typename Expr>
+nullable_column<T> & assign (nullable_column<T> & result, Expr const & expr)
+{
+    assert(boost::yap::fold(boost::yap::as_expr(expr), true, sizes_match{result.size()}));
+    for (std::size_t i = 0, size = result.size(); i < size; ++i) {
+        result.data[i] = boost::yap::evaluate(boost::yap::transform(expr, take_nth{i}));
+    }
+    std::uint64_t const last_word_mask = result.size() % 64 ?
+        (std::uint64_t(1) << result.size() % 64) - 1 :
+        ~std::uint64_t(0);
+    for (std::size_t w = 0, size = result.valid.size(); w < size; ++w) {
+        result.valid[w] = boost::yap::fold(expr, ~std::uint64_t(0), validity_word{w});
+    }
+    if (!result.valid.empty())
+        result.valid.back() &= last_word_mask;
+    return result;
+}
+//]
+
+template <typename T>
+std::ostream & print_row (std::ostream & os, nullable_column<T> const & column, std::size_t i)
+{
+    if (column.is_valid(i))
+        return os << column.data[i];
+    return os << "null";
+}
+
+int main ()
+{
+    std::size_t const n = 10;
+
+    nullable_column<double> price(n);
+    nullable_column<double> discount(n);
+    std::vector<double> quantity(n);
+
+    for (std::size_t i = 0; i < n; ++i) {
+        price.data[i] = 10.0 + i;
+        discount.data[i] = 0.5 * i;
+        quantity[i] = 1.0 + i % 3;
+    }
+    price.set_null(3);
+    discount.set_null(7);
+
+    nullable_column<double> total(n);
+    assign(total, (price - discount) * quantity);
+
+    for (std::size_t i = 0; i < n; ++i) {
+        std::cout << "total(" << i << ") = ";
+        print_row(std::cout, total, i) << "\n";
+    }
+
+    for (std::size_t i = 0; i < n; ++i) {
+        assert(total.is_valid(i) == (price.is_valid(i) && discount.is_valid(i)));
+    }
+
+    return 0;
+}
+//]
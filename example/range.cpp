@@ -0,0 +1,197 @@
+//[ range
+#include <boost/yap/yap.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+#if defined(__cpp_lib_parallel_algorithm)
+#include <execution>
+#endif
+
+
+// Define a type trait that identifies std::vectors.
+template <typename T>
+struct is_vector : std::false_type {};
+
+template <typename T, typename A>
+struct is_vector<std::vector<T, A>> : std::true_type {};
+
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(multiplies, boost::yap::expression, is_vector); // *
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(plus, boost::yap::expression, is_vector); // +
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(minus, boost::yap::expression, is_vector); // -
+
+
+//[ range_element
+// Element n of an expression.  Any terminal that can be indexed is replaced
+// by its nth element; any other terminal, such as a scalar, is left as it is.
+struct take_nth
+{
+    template <typename T>
+    auto operator() (boost::yap::terminal_tag, T const & t) ->
+        decltype(boost::yap::make_terminal(t[0]))
+    { return boost::yap::make_terminal(t[n]); }
+
+    std::size_t n;
+};
+
+// The number of elements in an expression, taken from the terminals that
+// have a size.
+struct element_count
+{
+    template <typename Expr>
+    auto operator() (std::size_t size, Expr const & expr) ->
+        decltype(boost::yap::value(expr).size())
+    { return std::max(size, boost::yap::value(expr).size()); }
+};
+
+template <typename Expr>
+auto element_of (Expr const & expr, std::size_t n)
+{ return boost::yap::evaluate(boost::yap::transform(expr, take_nth{n})); }
+//]
+
+
+//[ range_iterator
+// An iterator over the elements of an expression.  Each dereference
+// evaluates one element and returns it by value; nothing is stored.  Since
+// reference is not a reference type, this is only an input iterator to the
+// C++17 iterator requirements, though it supports every random access
+// operation.  Like the iterators of std::ranges::views::transform when the
+// function returns a value, it reports input_iterator_tag as its
+// iterator_category, and random_access_iterator_tag as its
+// iterator_concept, which C++20 ranges use.
+template <typename Expr>
+struct expr_iterator
+{
+    using value_type = std::decay_t<decltype(element_of(std::declval<Expr const &>(), 0))>;
+    using difference_type = std::ptrdiff_t;
+    using reference = value_type;
+    using pointer = void;
+    using iterator_category = std::input_iterator_tag;
+    using iterator_concept = std::random_access_iterator_tag;
+
+    expr_iterator () : expr (nullptr), n (0) {}
+    expr_iterator (Expr const * expr_, difference_type n_) : expr (expr_), n (n_) {}
+
+    reference operator* () const
+    { return element_of(*expr, n); }
+    reference operator[] (difference_type i) const
+    { return element_of(*expr, n + i); }
+
+    expr_iterator & operator++ () { ++n; return *this; }
+    expr_iterator & operator-- () { --n; return *this; }
+    expr_iterator operator++ (int) { expr_iterator retval = *this; ++n; return retval; }
+    expr_iterator operator-- (int) { expr_iterator retval = *this; --n; return retval; }
+    expr_iterator & operator+= (difference_type i) { n += i; return *this; }
+    expr_iterator & operator-= (difference_type i) { n -= i; return *this; }
+
+    friend expr_iterator operator+ (expr_iterator it, difference_type i) { return it += i; }
+    friend expr_iterator operator+ (difference_type i, expr_iterator it) { return it += i; }
+    friend expr_iterator operator- (expr_iterator it, difference_type i) { return it -= i; }
+    friend difference_type operator- (expr_iterator lhs, expr_iterator rhs) { return lhs.n - rhs.n; }
+
+    friend bool operator== (expr_iterator lhs, expr_iterator rhs) { return lhs.n == rhs.n; }
+    friend bool operator!= (expr_iterator lhs, expr_iterator rhs) { return lhs.n != rhs.n; }
+    friend bool operator< (expr_iterator lhs, expr_iterator rhs) { return lhs.n < rhs.n; }
+    friend bool operator> (expr_iterator lhs, expr_iterator rhs) { return lhs.n > rhs.n; }
+    friend bool operator<= (expr_iterator lhs, expr_iterator rhs) { return lhs.n <= rhs.n; }
+    friend bool operator>= (expr_iterator lhs, expr_iterator rhs) { return lhs.n >= rhs.n; }
+
+    Expr const * expr;
+    difference_type n;
+};
+//]
+
+
+//[ range_range
+// An expression viewed as a range of its elements.  The range holds a copy
+// of the expression, which refers to its terminals the same way the original
+// does; the terminals must outlive the range.
+template <typename Expr>
+struct expr_range
+{
+    using iterator = expr_iterator<Expr>;
+
+    iterator begin () const { return iterator(std::addressof(expr), 0); }
+    iterator end () const { return iterator(std::addressof(expr), size_); }
+    std::size_t size () const { return size_; }
+
+    typename iterator::reference operator[] (std::size_t n) const
+    { return element_of(expr, n); }
+
+    Expr expr;
+    std::ptrdiff_t size_;
+};
+
+template <typename Expr>
+auto as_range (Expr const & e)
+{
+    auto expr = boost::yap::as_expr(e);
+    std::ptrdiff_t const size = boost::yap::fold(expr, std::size_t(0), element_count{});
+    return expr_range<decltype(expr)>{std::move(expr), size};
+}
+//]
+
+int main ()
+{
+    std::size_t const n = 1 << 20;
+
+    std::vector<double> a(n);
+    std::vector<double> b(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        a[i] = double(i % 10);
+        b[i] = 0.5 * double(i % 4);
+    }
+
+    auto const r = as_range(a * b + 1.0);
+    assert(r.size() == n);
+    assert(r[3] == a[3] * b[3] + 1.0);
+
+    // Materialize the range with an ordinary algorithm.
+    std::vector<double> c(n);
+    std::copy(r.begin(), r.end(), c.begin());
+    assert(c[5] == a[5] * b[5] + 1.0);
+
+    // Or consume it without materializing it at all.
+    double const sum = std::accumulate(r.begin(), r.end(), 0.0);
+    std::cout << "sum = " << sum << "\n";
+
+#if defined(__cpp_lib_parallel_algorithm)
+    // The same, in parallel, and a dot product of two expressions.  The
+    // parallel algorithms need forward iterators, which expr_iterator is not,
+    // so they iterate over the indices of the elements instead, and evaluate
+    // each element inside the callable.  Every element is a multiple of 0.5,
+    // so the sums are exact in any order.
+    std::vector<std::size_t> indices(n);
+    std::iota(indices.begin(), indices.end(), std::size_t(0));
+    double const parallel_sum = std::transform_reduce(
+        std::execution::par_unseq,
+        indices.begin(), indices.end(), 0.0, std::plus<>(),
+        [&r](std::size_t i) { return r[i]; }
+    );
+    assert(parallel_sum == sum);
+
+    auto const diff = as_range(a - b);
+    double const dot = std::transform_reduce(
+        std::execution::par_unseq,
+        indices.begin(), indices.end(), 0.0, std::plus<>(),
+        [&r, &diff](std::size_t i) { return r[i] * diff[i]; }
+    );
+    double expected = 0.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        expected += (a[i] * b[i] + 1.0) * (a[i] - b[i]);
+    }
+    std::cout << "dot = " << dot << "\n";
+    assert(dot == expected);
+    (void)parallel_sum;
+#endif
+
+    return 0;
+}
+//]
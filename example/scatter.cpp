@@ -0,0 +1,272 @@
+//[ scatter
+#include <boost/yap/yap.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+
+// Define a type trait that identifies std::vectors.
+template <typename T>
+struct is_vector : std::false_type {};
+
+template <typename T, typename A>
+struct is_vector<std::vector<T, A>> : std::true_type {};
+
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(multiplies, boost::yap::expression, is_vector); // *
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(divides, boost::yap::expression, is_vector); // /
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(modulus, boost::yap::expression, is_vector); // %
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(plus, boost::yap::expression, is_vector); // +
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(minus, boost::yap::expression, is_vector); // -
+
+
+struct take_nth
+{
+    template <typename T>
+    auto operator() (boost::yap::terminal_tag, std::vector<T> const & vec)
+    { return boost::yap::make_terminal(vec[n]); }
+
+    std::size_t n;
+};
+
+struct vector_size
+{
+    template <typename Expr>
+    auto operator() (std::size_t size, Expr const & expr) ->
+        decltype(boost::yap::value(expr).size())
+    { return std::max(size, boost::yap::value(expr).size()); }
+};
+
+// True iff every std::vector<> terminal that the running value is folded
+// over has size elements.
+struct sizes_match
+{
+    template <typename Expr>
+    auto operator() (bool match, Expr const & expr) ->
+        decltype(boost::yap::value(expr).size(), bool())
+    { return match && boost::yap::value(expr).size() == size; }
+
+    std::size_t size;
+};
+
+
+//[ scatter_strategy
+// How the updates of a scatter are divided among threads.
+//
+// - serial: one thread does all of them.
+//
+// - privatized: each thread accumulates into its own zeroed copy of the
+//   destination, and the copies are then summed into it.  This costs a copy
+//   of the destination per thread, so it suits small destinations, such as
+//   the bins of a histogram.
+//
+// - sharded: the destination is split into one contiguous shard per thread.
+//   Each thread evaluates a part of the elements, and buckets each update by
+//   the shard it falls in; then each thread applies all the updates to its
+//   own shard.  No two threads ever write the same element, so no atomics or
+//   locks are needed, and the extra memory is proportional to the number of
+//   updates, not to the size of the destination.
+enum class scatter_strategy { serial, privatized, sharded };
+
+struct scatter_options
+{
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    // Destinations of at most this many elements are privatized; larger ones
+    // are sharded.
+    std::size_t privatize_limit = 1 << 16;
+    // Scatters of fewer elements than this are not worth starting threads for.
+    std::size_t min_parallel_size = 1 << 14;
+};
+
+inline scatter_strategy choose_strategy (std::size_t dest_size, std::size_t size, scatter_options const & options)
+{
+    if (options.threads <= 1 || size < options.min_parallel_size)
+        return scatter_strategy::serial;
+    if (dest_size <= options.privatize_limit)
+        return scatter_strategy::privatized;
+    return scatter_strategy::sharded;
+}
+
+// Runs f(t, first, last) on thread t, for each of threads contiguous parts
+// of [0, size), and waits for all of them to finish.
+template <typename F>
+void parallel_for (unsigned threads, std::size_t size, F f)
+{
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        std::size_t const first = size * t / threads;
+        std::size_t const last = size * (t + 1) / threads;
+        workers.emplace_back([=, &f]() { f(t, first, last); });
+    }
+    for (std::thread & worker : workers) {
+        worker.join();
+    }
+}
+//]
+
+
+//[ scatter_add
+// For each element i of index_expr and value_expr, adds value_expr[i] to
+// dest[index_expr[i]].  value_expr may be a scalar, which is added at every
+// index.  If any index is out of range, its update is skipped, and
+// std::out_of_range is thrown after every other update has been applied;
+// throwing from one of the threads would terminate the program instead.
+template <typename T, typename IndexExpr, typename ValueExpr>
+std::vector<T> & scatter_add (
+    std::vector<T> & dest,
+    IndexExpr const & index_e,
+    ValueExpr const & value_e,
+    scatter_options const & options = scatter_options()
+) {
+    decltype(auto) index_expr = boost::yap::as_expr(index_e);
+    decltype(auto) value_expr = boost::yap::as_expr(value_e);
+    std::size_t const size = std::max(
+        boost::yap::fold(index_expr, std::size_t(0), vector_size{}),
+        boost::yap::fold(value_expr, std::size_t(0), vector_size{})
+    );
+    assert(boost::yap::fold(index_expr, true, sizes_match{size}));
+    assert(boost::yap::fold(value_expr, true, sizes_match{size}));
+
+    // Calls f(index, value) for each of the elements [first, last) whose
+    // index is in range.
+    std::atomic<bool> index_out_of_range(false);
+    auto const for_each_update = [&](std::size_t first, std::size_t last, auto f) {
+        bool out_of_range = false;
+        for (std::size_t i = first; i < last; ++i) {
+            std::size_t const index = boost::yap::evaluate(boost::yap::transform(index_expr, take_nth{i}));
+            if (dest.size() <= index) {
+                out_of_range = true;
+                continue;
+            }
+            f(index, T(boost::yap::evaluate(boost::yap::transform(value_expr, take_nth{i}))));
+        }
+        if (out_of_range)
+            index_out_of_range = true;
+    };
+
+    switch (choose_strategy(dest.size(), size, options)) {
+    case scatter_strategy::serial:
+        for_each_update(0, size, [&](std::size_t index, T value) {
+            dest[index] += value;
+        });
+        break;
+
+    case scatter_strategy::privatized: {
+        unsigned const threads = options.threads;
+        std::vector<std::vector<T>> privates(threads);
+        parallel_for(threads, size, [&](unsigned t, std::size_t first, std::size_t last) {
+            std::vector<T> & private_dest = privates[t];
+            private_dest.assign(dest.size(), T(0));
+            for_each_update(first, last, [&](std::size_t index, T value) {
+                private_dest[index] += value;
+            });
+        });
+        parallel_for(threads, dest.size(), [&](unsigned, std::size_t first, std::size_t last) {
+            for (std::vector<T> const & private_dest : privates) {
+                for (std::size_t j = first; j < last; ++j) {
+                    dest[j] += private_dest[j];
+                }
+            }
+        });
+        break;
+    }
+
+    case scatter_strategy::sharded: {
+        unsigned const threads = options.threads;
+        std::size_t const shard_size = (dest.size() + threads - 1) / threads;
+        // buckets[t][s] holds the updates found by thread t for shard s.
+        std::vector<std::vector<std::vector<std::pair<std::size_t, T>>>> buckets(
+            threads, std::vector<std::vector<std::pair<std::size_t, T>>>(threads)
+        );
+        parallel_for(threads, size, [&](unsigned t, std::size_t first, std::size_t last) {
+            for_each_update(first, last, [&](std::size_t index, T value) {
+                buckets[t][index / shard_size].emplace_back(index, value);
+            });
+        });
+        parallel_for(threads, threads, [&](unsigned s, std::size_t, std::size_t) {
+            for (unsigned t = 0; t < threads; ++t) {
+                for (std::pair<std::size_t, T> const & update : buckets[t][s]) {
+                    dest[update.first] += update.second;
+                }
+            }
+        });
+        break;
+    }
+    }
+
+    if (index_out_of_range)
+        throw std::out_of_range("scatter_add: index out of range");
+    return dest;
+}
+
+// Counts the occurrences of each bin index in index_expr.
+template <typename T, typename IndexExpr>
+std::vector<T> & histogram (
+    std::vector<T> & bins,
+    IndexExpr const & index_expr,
+    scatter_options const & options = scatter_options()
+) { return scatter_add(bins, index_expr, T(1), options); }
+//]
+
+int main ()
+{
+    std::size_t const n = 1 << 20;
+
+    std::vector<std::size_t> keys(n);
+    std::vector<double> weights(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        keys[i] = (i * 2654435761u) % n;
+        weights[i] = 0.5 * double(i % 4);
+    }
+
+    scatter_options options;
+    options.threads = 4;
+
+    // A histogram of 100 bins is privatized.
+    assert(choose_strategy(100, n, options) == scatter_strategy::privatized);
+    std::vector<int> bins(100);
+    histogram(bins, keys % std::size_t(100), options);
+    std::vector<int> expected_bins(100);
+    for (std::size_t i = 0; i < n; ++i) {
+        ++expected_bins[keys[i] % 100];
+    }
+    assert(bins == expected_bins);
+    std::cout << "bins[0] = " << bins[0] << "\n";
+
+    // A scatter into a million elements is sharded.
+    assert(choose_strategy(n, n, options) == scatter_strategy::sharded);
+    std::vector<double> dest(n);
+    scatter_add(dest, keys / std::size_t(2), weights * 2.0 + 1.0, options);
+    std::vector<double> expected(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        expected[keys[i] / 2] += weights[i] * 2.0 + 1.0;
+    }
+    assert(dest == expected);
+
+    // With a single thread, the same scatter is serial.
+    options.threads = 1;
+    std::vector<double> serial_dest(n);
+    scatter_add(serial_dest, keys / std::size_t(2), weights * 2.0 + 1.0, options);
+    assert(serial_dest == expected);
+
+    // An index past the end of the destination is reported, not written.
+    options.threads = 4;
+    std::vector<double> small_dest(n / 4);
+    bool threw = false;
+    try {
+        scatter_add(small_dest, keys / std::size_t(2), weights * 2.0 + 1.0, options);
+    } catch (std::out_of_range const &) {
+        threw = true;
+    }
+    assert(threw);
+    (void)threw;
+
+    return 0;
+}
+//]
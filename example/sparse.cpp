@@ -0,0 +1,318 @@
+//[ sparse
+#include <boost/yap/yap.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+
+//[ sparse_vector
+// A vector of size elements, all zero except values[i] at indices[i].  The
+// indices are sorted and unique.
+struct sparse_vector
+{
+    std::vector<double> to_dense () const
+    {
+        std::vector<double> retval(size, 0.0);
+        for (std::size_t k = 0; k < indices.size(); ++k) {
+            retval[indices[k]] = values[k];
+        }
+        return retval;
+    }
+
+    std::size_t size;
+    std::vector<std::size_t> indices;
+    std::vector<double> values;
+};
+
+inline sparse_vector to_sparse (std::vector<double> const & dense)
+{
+    sparse_vector retval{dense.size(), {}, {}};
+    for (std::size_t i = 0; i < dense.size(); ++i) {
+        if (dense[i] != 0.0) {
+            retval.indices.push_back(i);
+            retval.values.push_back(dense[i]);
+        }
+    }
+    return retval;
+}
+//]
+
+// Define a type trait that identifies sparse and dense vectors.
+template <typename T>
+struct is_vector : std::false_type {};
+
+template <typename T, typename A>
+struct is_vector<std::vector<T, A>> : std::true_type {};
+
+template <>
+struct is_vector<sparse_vector> : std::true_type {};
+
+BOOST_YAP_USER_UDT_UNARY_OPERATOR(negate, boost::yap::expression, is_vector); // -
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(multiplies, boost::yap::expression, is_vector); // *
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(divides, boost::yap::expression, is_vector); // /
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(plus, boost::yap::expression, is_vector); // +
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(minus, boost::yap::expression, is_vector); // -
+
+
+//[ sparse_pattern
+// The indices at which an expression may be nonzero; or, if dense is true,
+// possibly all of them.
+struct pattern
+{
+    bool dense;
+    std::vector<std::size_t> indices;
+};
+
+// Computes the pattern of an expression from the patterns of its operands.
+// A sum or difference may be nonzero wherever either operand is, so it takes
+// the union of their patterns; a product, only where both are, so it takes
+// the intersection.  Both are computed with a single merge over the two
+// sorted index lists.  Dense vectors and scalars may be nonzero anywhere.
+//
+// Once a pattern covers more than max_density of the indices, it is
+// treated as dense: iterating over it would save little, and merging it with
+// others would cost more than it saves.
+struct compute_pattern
+{
+    pattern operator() (boost::yap::terminal_tag, sparse_vector const & v) const
+    { return limit_density(pattern{false, v.indices}); }
+
+    template <typename T>
+    pattern operator() (boost::yap::terminal_tag, T const &) const
+    { return pattern{true, {}}; }
+
+    template <typename Expr1, typename Expr2>
+    pattern operator() (boost::yap::plus_tag, Expr1 const & expr1, Expr2 const & expr2) const
+    { return merge_union(boost::yap::transform(expr1, *this), boost::yap::transform(expr2, *this)); }
+
+    template <typename Expr1, typename Expr2>
+    pattern operator() (boost::yap::minus_tag, Expr1 const & expr1, Expr2 const & expr2) const
+    { return merge_union(boost::yap::transform(expr1, *this), boost::yap::transform(expr2, *this)); }
+
+    template <typename Expr1, typename Expr2>
+    pattern operator() (boost::yap::multiplies_tag, Expr1 const & expr1, Expr2 const & expr2) const
+    { return merge_intersection(boost::yap::transform(expr1, *this), boost::yap::transform(expr2, *this)); }
+
+    // 0 / y is 0 for any nonzero y.
+    template <typename Expr1, typename Expr2>
+    pattern operator() (boost::yap::divides_tag, Expr1 const & expr1, Expr2 const &) const
+    { return boost::yap::transform(expr1, *this); }
+
+    template <typename Expr>
+    pattern operator() (boost::yap::negate_tag, Expr const & expr) const
+    { return boost::yap::transform(expr, *this); }
+
+    pattern limit_density (pattern p) const
+    {
+        if (!p.dense && max_density * double(size) < double(p.indices.size()))
+            return pattern{true, {}};
+        return p;
+    }
+
+    pattern merge_union (pattern const & lhs, pattern const & rhs) const
+    {
+        if (lhs.dense || rhs.dense)
+            return pattern{true, {}};
+        pattern retval{false, {}};
+        retval.indices.reserve(lhs.indices.size() + rhs.indices.size());
+        std::set_union(
+            lhs.indices.begin(), lhs.indices.end(),
+            rhs.indices.begin(), rhs.indices.end(),
+            std::back_inserter(retval.indices)
+        );
+        return limit_density(std::move(retval));
+    }
+
+    pattern merge_intersection (pattern const & lhs, pattern const & rhs) const
+    {
+        if (lhs.dense)
+            return rhs;
+        if (rhs.dense)
+            return lhs;
+        pattern retval{false, {}};
+        std::set_intersection(
+            lhs.indices.begin(), lhs.indices.end(),
+            rhs.indices.begin(), rhs.indices.end(),
+            std::back_inserter(retval.indices)
+        );
+        return retval;
+    }
+
+    std::size_t size;
+    double max_density;
+};
+//]
+
+
+//[ sparse_cursor
+// A position within a sparse_vector.  Since the indices at which an
+// expression is evaluated only ever increase, the position only moves
+// forward; finding the value at each index is a step of a merge, not a
+// search.
+struct sparse_cursor
+{
+    double at (std::size_t i) const
+    {
+        while (position < v->indices.size() && v->indices[position] < i) {
+            ++position;
+        }
+        if (position < v->indices.size() && v->indices[position] == i)
+            return v->values[position];
+        return 0.0;
+    }
+
+    sparse_vector const * v;
+    mutable std::size_t position;
+};
+
+struct bind_cursors
+{
+    auto operator() (boost::yap::terminal_tag, sparse_vector const & v)
+    { return boost::yap::make_terminal(sparse_cursor{&v, 0}); }
+};
+
+struct take_nth
+{
+    template <typename T>
+    auto operator() (boost::yap::terminal_tag, std::vector<T> const & vec)
+    { return boost::yap::make_terminal(vec[n]); }
+
+    auto operator() (boost::yap::terminal_tag, sparse_cursor const & cursor)
+    { return boost::yap::make_terminal(cursor.at(n)); }
+
+    std::size_t n;
+};
+
+struct vector_size
+{
+    template <typename Expr>
+    auto operator() (std::size_t size, Expr const & expr) ->
+        decltype(boost::yap::value(expr).size, std::size_t())
+    { return std::max(size, boost::yap::value(expr).size); }
+
+    template <typename Expr>
+    auto operator() (std::size_t size, Expr const & expr) ->
+        decltype(boost::yap::value(expr).size())
+    { return std::max(size, boost::yap::value(expr).size()); }
+};
+//]
+
+
+//[ sparse_evaluate
+constexpr double default_max_density = 0.25;
+
+// Calls f(i, value) for each index i at which expr may be nonzero, in
+// increasing order.
+template <typename Expr, typename F>
+void for_each_nonzero (Expr const & expr, double max_density, F f)
+{
+    std::size_t const size = boost::yap::fold(expr, std::size_t(0), vector_size{});
+    pattern const p = boost::yap::transform(expr, compute_pattern{size, max_density});
+    auto const bound = boost::yap::transform(expr, bind_cursors{});
+    auto const eval_at = [&](std::size_t i) {
+        f(i, double(boost::yap::evaluate(boost::yap::transform(bound, take_nth{i}))));
+    };
+    if (p.dense) {
+        for (std::size_t i = 0; i < size; ++i) {
+            eval_at(i);
+        }
+    } else {
+        for (std::size_t i : p.indices) {
+            eval_at(i);
+        }
+    }
+}
+
+// Evaluates expr into a sparse_vector.
+template <typename Expr>
+sparse_vector evaluate_sparse (Expr const & expr, double max_density = default_max_density)
+{
+    sparse_vector retval{boost::yap::fold(expr, std::size_t(0), vector_size{}), {}, {}};
+    for_each_nonzero(expr, max_density, [&](std::size_t i, double value) {
+        if (value != 0.0) {
+            retval.indices.push_back(i);
+            retval.values.push_back(value);
+        }
+    });
+    return retval;
+}
+
+// Evaluates expr into a dense vector.  Only the elements that may be nonzero
+// are evaluated; the rest are set to zero.
+template <typename Expr>
+std::vector<double> & assign (std::vector<double> & vec, Expr const & expr, double max_density = default_max_density)
+{
+    vec.assign(boost::yap::fold(expr, std::size_t(0), vector_size{}), 0.0);
+    for_each_nonzero(expr, max_density, [&](std::size_t i, double value) {
+        vec[i] = value;
+    });
+    return vec;
+}
+//]
+
+int main ()
+{
+    std::size_t const n = 100000;
+
+    // Two feature vectors, 99% zeros, and a dense vector of weights.
+    std::vector<double> a_dense(n, 0.0);
+    std::vector<double> b_dense(n, 0.0);
+    std::vector<double> weights(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        if (i % 100 == 0)
+            a_dense[i] = 1.0 + double(i % 7);
+        if (i % 150 == 0)
+            b_dense[i] = 2.0 + double(i % 5);
+        weights[i] = 0.5 + double(i % 3);
+    }
+    sparse_vector const a = to_sparse(a_dense);
+    sparse_vector const b = to_sparse(b_dense);
+
+    // The union of the patterns of a and b.
+    sparse_vector const sum = evaluate_sparse(a + b * 2.0);
+    std::cout << "a + b * 2 has " << sum.indices.size() << " nonzeros\n";
+
+    // The intersection.
+    sparse_vector const product = evaluate_sparse(a * b);
+    std::cout << "a * b has " << product.indices.size() << " nonzeros\n";
+
+    // The pattern of a, even though weights is dense.
+    sparse_vector const weighted = evaluate_sparse(weights * (a - b));
+    std::cout << "weights * (a - b) has " << weighted.indices.size() << " nonzeros\n";
+
+    // Dense everywhere.
+    std::vector<double> shifted;
+    assign(shifted, a + weights);
+
+    // Each of c and d is 20% nonzeros, below the default threshold of 25%;
+    // their union is not, so it is evaluated densely.
+    std::vector<double> c_dense(n, 0.0);
+    std::vector<double> d_dense(n, 0.0);
+    for (std::size_t i = 0; i < n; ++i) {
+        if (i % 5 == 0)
+            c_dense[i] = 1.0;
+        if (i % 5 == 1)
+            d_dense[i] = 3.0;
+    }
+    sparse_vector const c = to_sparse(c_dense);
+    sparse_vector const d = to_sparse(d_dense);
+    std::vector<double> dense_sum;
+    assign(dense_sum, c + d);
+
+    std::vector<double> const sum_dense = sum.to_dense();
+    std::vector<double> const product_dense = product.to_dense();
+    std::vector<double> const weighted_dense = weighted.to_dense();
+    for (std::size_t i = 0; i < n; ++i) {
+        assert(sum_dense[i] == a_dense[i] + b_dense[i] * 2.0);
+        assert(product_dense[i] == a_dense[i] * b_dense[i]);
+        assert(weighted_dense[i] == weights[i] * (a_dense[i] - b_dense[i]));
+        assert(shifted[i] == a_dense[i] + weights[i]);
+        assert(dense_sum[i] == c_dense[i] + d_dense[i]);
+    }
+
+    return 0;
+}
+//]
@@ -0,0 +1,231 @@
+//[ stencil
+#include <boost/yap/yap.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iostream>
+#include <vector>
+
+
+//[ stencil_shift
+// Element i of a shifted<T> is element i + offset of the vector it refers to.
+template <typename T>
+struct shifted
+{
+    std::vector<T> const * vec;
+    std::ptrdiff_t offset;
+};
+
+template <typename T>
+auto shift (std::vector<T> const & vec, std::ptrdiff_t offset)
+{ return boost::yap::make_terminal(shifted<T>{&vec, offset}); }
+
+// How an element outside a vector is read: from the nearest element within
+// it, from the other end of it, or as zero.
+enum class boundary { clamp, wrap, zero };
+//]
+
+// Define a type trait that identifies std::vectors.
+template <typename T>
+struct is_vector : std::false_type {};
+
+template <typename T, typename A>
+struct is_vector<std::vector<T, A>> : std::true_type {};
+
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(multiplies, boost::yap::expression, is_vector); // *
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(plus, boost::yap::expression, is_vector); // +
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(minus, boost::yap::expression, is_vector); // -
+
+
+//[ stencil_halo
+// The widths of the halos of an expression: how far its shifts reach before
+// the first element and past the last one.
+struct halo
+{
+    std::size_t size;
+    std::ptrdiff_t before;
+    std::ptrdiff_t after;
+};
+
+struct find_halo
+{
+    template <typename T>
+    static halo widen (halo h, std::vector<T> const & vec)
+    { return halo{std::max(h.size, vec.size()), h.before, h.after}; }
+
+    template <typename T>
+    static halo widen (halo h, shifted<T> const & s)
+    {
+        return halo{
+            std::max(h.size, s.vec->size()),
+            std::max(h.before, -s.offset),
+            std::max(h.after, s.offset)
+        };
+    }
+
+    template <typename Expr>
+    auto operator() (halo h, Expr const & expr) ->
+        decltype(widen(h, boost::yap::value(expr)))
+    { return widen(h, boost::yap::value(expr)); }
+};
+
+// True iff every vector that the running value is folded over, shifted or
+// not, has size elements.
+struct sizes_match
+{
+    template <typename T>
+    static std::size_t size_of (std::vector<T> const & vec)
+    { return vec.size(); }
+
+    template <typename T>
+    static std::size_t size_of (shifted<T> const & s)
+    { return s.vec->size(); }
+
+    template <typename Expr>
+    auto operator() (bool match, Expr const & expr) const ->
+        decltype(size_of(boost::yap::value(expr)), bool())
+    { return match && size_of(boost::yap::value(expr)) == size; }
+
+    std::size_t size;
+};
+//]
+
+
+//[ stencil_interior
+// In the interior, every shifted access is in bounds, so each operand is
+// reduced to a pointer to the element it reads at the first interior index,
+// first, and element first + i of the expression reads element i of each
+// pointer.  Since the halo is at least as wide as each shift, each of these
+// pointers is within its vector.
+template <typename T>
+struct base_pointer
+{
+    T const * ptr;
+};
+
+struct bind_pointers
+{
+    template <typename T>
+    auto operator() (boost::yap::terminal_tag, std::vector<T> const & vec)
+    { return boost::yap::make_terminal(base_pointer<T>{vec.data() + first}); }
+
+    template <typename T>
+    auto operator() (boost::yap::terminal_tag, shifted<T> const & s)
+    { return boost::yap::make_terminal(base_pointer<T>{s.vec->data() + (std::ptrdiff_t(first) + s.offset)}); }
+
+    std::size_t first;
+};
+
+struct take_interior
+{
+    template <typename T>
+    auto operator() (boost::yap::terminal_tag, base_pointer<T> const & p)
+    { return boost::yap::make_terminal(p.ptr[n]); }
+
+    std::size_t n;
+};
+//]
+
+
+//[ stencil_boundary
+// In the halos, each shifted access is checked, and handled according to the
+// boundary policy.
+struct take_boundary
+{
+    template <typename T>
+    auto operator() (boost::yap::terminal_tag, std::vector<T> const & vec)
+    { return boost::yap::make_terminal(vec[n]); }
+
+    template <typename T>
+    auto operator() (boost::yap::terminal_tag, shifted<T> const & s)
+    {
+        std::vector<T> const & vec = *s.vec;
+        std::ptrdiff_t const size = vec.size();
+        std::ptrdiff_t i = std::ptrdiff_t(n) + s.offset;
+        if (i < 0 || size <= i) {
+            switch (policy) {
+            case boundary::clamp: i = i < 0 ? 0 : size - 1; break;
+            case boundary::wrap: i = (i % size + size) % size; break;
+            case boundary::zero: return boost::yap::make_terminal(T(0));
+            }
+        }
+        return boost::yap::make_terminal(T(vec[i]));
+    }
+
+    std::size_t n;
+    boundary policy;
+};
+
+// Assigns expr to vec.  vec must not appear in expr, since its elements are
+// overwritten while its neighbors may still be read.
+template <typename T, typename Expr>
+std::vector<T> & assign (std::vector<T> & vec, Expr const & expr, boundary policy)
+{
+    halo const h = boost::yap::fold(boost::yap::as_expr(expr), halo{0, 0, 0}, find_halo{});
+    std::size_t const size = h.size;
+    std::size_t const first = std::min<std::size_t>(h.before, size);
+    std::size_t const last = std::max(first, size - std::min<std::size_t>(h.after, size));
+    assert(boost::yap::fold(boost::yap::as_expr(expr), true, sizes_match{size}));
+    vec.resize(size);
+
+    for (std::size_t i = 0; i < first; ++i) {
+        vec[i] = boost::yap::evaluate(boost::yap::transform(boost::yap::as_expr(expr), take_boundary{i, policy}));
+    }
+
+    if (first < last) {
+        auto const bound = boost::yap::transform(boost::yap::as_expr(expr), bind_pointers{first});
+        T * const out = vec.data() + first;
+        for (std::size_t i = 0; i < last - first; ++i) {
+            out[i] = boost::yap::evaluate(boost::yap::transform(bound, take_interior{i}));
+        }
+    }
+
+    for (std::size_t i = last; i < size; ++i) {
+        vec[i] = boost::yap::evaluate(boost::yap::transform(boost::yap::as_expr(expr), take_boundary{i, policy}));
+    }
+
+    return vec;
+}
+//]
+
+int main ()
+{
+    std::size_t const n = 1000;
+
+    std::vector<double> v(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        v[i] = double((i * 37) % 101);
+    }
+
+    auto const at = [&](std::ptrdiff_t i, boundary policy) {
+        std::ptrdiff_t const size = n;
+        if (0 <= i && i < size)
+            return v[i];
+        switch (policy) {
+        case boundary::clamp: return v[i < 0 ? 0 : size - 1];
+        case boundary::wrap: return v[(i + size) % size];
+        case boundary::zero: return 0.0;
+        }
+        return 0.0;
+    };
+
+    std::vector<double> smoothed;
+    for (boundary policy : {boundary::clamp, boundary::wrap, boundary::zero}) {
+        assign(smoothed, 0.25 * (shift(v, -1) + 2.0 * v + shift(v, 1)), policy);
+        for (std::ptrdiff_t i = 0; i < std::ptrdiff_t(n); ++i) {
+            assert(smoothed[i] == 0.25 * (at(i - 1, policy) + 2.0 * v[i] + at(i + 1, policy)));
+        }
+    }
+    std::cout << "smoothed[0] = " << smoothed[0] << "\n";
+
+    // A one-sided difference has a halo on one side only.
+    std::vector<double> gradient;
+    assign(gradient, shift(v, 2) - v, boundary::clamp);
+    assert(gradient[0] == v[2] - v[0]);
+    assert(gradient[n - 1] == 0.0);
+    assert(gradient[n - 2] == v[n - 1] - v[n - 2]);
+
+    return 0;
+}
+//]
@@ -0,0 +1,426 @@
+//[ tensor
+#include <boost/yap/yap.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+
+//[ tensor_types
+using shape_t = std::vector<std::size_t>;
+using strides_t = std::vector<std::ptrdiff_t>;
+
+// Element i of a tensor is at data()[sum over d of i[d] * strides[d]].
+// Strides are in elements, and may be zero or negative.
+template <typename T>
+struct tensor_view
+{
+    T const * data () const { return data_; }
+
+    T const & operator() (shape_t const & i) const
+    { return data_[std::inner_product(i.begin(), i.end(), strides.begin(), std::ptrdiff_t(0))]; }
+
+    T const * data_;
+    shape_t shape;
+    strides_t strides;
+};
+
+// A tensor that owns its elements, stored in row-major order.
+template <typename T>
+struct tensor
+{
+    explicit tensor (shape_t shape_ = shape_t(), T value = T()) :
+        shape (std::move(shape_)),
+        strides (shape.size()),
+        elements (std::accumulate(shape.begin(), shape.end(), std::size_t(1), std::multiplies<>()), value)
+    {
+        std::ptrdiff_t stride = 1;
+        for (std::size_t d = shape.size(); d-- > 0;) {
+            strides[d] = stride;
+            stride *= std::ptrdiff_t(shape[d]);
+        }
+    }
+
+    T const * data () const { return elements.data(); }
+    T * data () { return elements.data(); }
+
+    T const & operator() (shape_t const & i) const
+    { return elements[std::inner_product(i.begin(), i.end(), strides.begin(), std::ptrdiff_t(0))]; }
+    T & operator() (shape_t const & i)
+    { return elements[std::inner_product(i.begin(), i.end(), strides.begin(), std::ptrdiff_t(0))]; }
+
+    shape_t shape;
+    strides_t strides;
+    std::vector<T> elements;
+};
+
+// Reverses the order of t's dimensions, without moving any elements.
+template <typename T>
+tensor_view<T> transpose (tensor<T> const & t)
+{ return tensor_view<T>{t.data(), shape_t(t.shape.rbegin(), t.shape.rend()), strides_t(t.strides.rbegin(), t.strides.rend())}; }
+//]
+
+// Define a type trait that identifies tensors and tensor_views.
+template <typename T>
+struct is_tensor : std::false_type {};
+
+template <typename T>
+struct is_tensor<tensor<T>> : std::true_type {};
+
+template <typename T>
+struct is_tensor<tensor_view<T>> : std::true_type {};
+
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(multiplies, boost::yap::expression, is_tensor); // *
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(divides, boost::yap::expression, is_tensor); // /
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(plus, boost::yap::expression, is_tensor); // +
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(minus, boost::yap::expression, is_tensor); // -
+
+
+//[ tensor_broadcast
+// One tensor operand of an expression: its address, which identifies it,
+// its first element, and its strides broadcast to the shape of the result.
+struct operand
+{
+    void const * tensor;
+    void const * data;
+    strides_t strides;
+};
+
+// Computes the shape of the result by NumPy's broadcasting rules: shapes are
+// aligned at their last dimensions, and each dimension of the result is the
+// one extent of that dimension that is not 1.
+struct broadcast_shape
+{
+    template <typename Expr>
+    auto operator() (shape_t shape, Expr const & expr) ->
+        decltype(boost::yap::value(expr).strides, shape_t())
+    {
+        shape_t const & other = boost::yap::value(expr).shape;
+        if (shape.size() < other.size())
+            shape.insert(shape.begin(), other.size() - shape.size(), 1);
+        std::size_t const offset = shape.size() - other.size();
+        for (std::size_t d = 0; d < other.size(); ++d) {
+            std::size_t & extent = shape[offset + d];
+            assert(extent == 1 || other[d] == 1 || extent == other[d]);
+            if (extent == 1)
+                extent = other[d];
+        }
+        return shape;
+    }
+};
+
+// Broadcasts strides, of a tensor with the given shape, to result_shape.
+// The stride of a dimension that is missing, or has extent 1, is zero, so
+// that every index along it gives the same element.
+inline strides_t broadcast_strides (shape_t const & shape, strides_t const & strides, shape_t const & result_shape)
+{
+    strides_t retval(result_shape.size(), 0);
+    std::size_t const offset = result_shape.size() - shape.size();
+    for (std::size_t d = 0; d < shape.size(); ++d) {
+        if (shape[d] != 1)
+            retval[offset + d] = strides[d];
+    }
+    return retval;
+}
+
+struct collect_operands
+{
+    template <typename Expr>
+    auto operator() (std::vector<operand> operands, Expr const & expr) ->
+        decltype(boost::yap::value(expr).strides, std::vector<operand>())
+    {
+        auto const & t = boost::yap::value(expr);
+        operands.push_back(operand{&t, t.data(), broadcast_strides(t.shape, t.strides, result_shape)});
+        return operands;
+    }
+
+    shape_t const & result_shape;
+};
+//]
+
+
+//[ tensor_loop_nest
+// A loop nest over the result.  Loop l runs extents[l] times, and each step
+// advances operand k by strides[l][k] elements.  The last loop is the
+// innermost.
+struct loop_nest
+{
+    shape_t extents;
+    std::vector<strides_t> strides;
+};
+
+// Orders the dimensions of the result so that the innermost loop walks the
+// smallest strides, summed over all the operands; then merges each pair of
+// adjacent loops that every operand walks as if they were one loop.  A fully
+// contiguous expression becomes a single loop, however many dimensions it
+// has.
+inline loop_nest plan_loops (shape_t const & shape, std::vector<operand> const & operands)
+{
+    auto const stride_of = [&](std::size_t d, std::size_t k) { return operands[k].strides[d]; };
+    auto const cost = [&](std::size_t d) {
+        std::ptrdiff_t retval = 0;
+        for (std::size_t k = 0; k < operands.size(); ++k) {
+            retval += std::abs(stride_of(d, k));
+        }
+        return retval;
+    };
+
+    std::vector<std::size_t> dims;
+    for (std::size_t d = 0; d < shape.size(); ++d) {
+        if (shape[d] != 1)
+            dims.push_back(d);
+    }
+    std::stable_sort(dims.begin(), dims.end(), [&](std::size_t lhs, std::size_t rhs) {
+        return cost(rhs) < cost(lhs);
+    });
+
+    loop_nest retval;
+    for (std::size_t d : dims) {
+        strides_t strides(operands.size());
+        for (std::size_t k = 0; k < operands.size(); ++k) {
+            strides[k] = stride_of(d, k);
+        }
+        retval.extents.push_back(shape[d]);
+        retval.strides.push_back(std::move(strides));
+    }
+
+    // Merge loops from the inside out.  Outer loop o and inner loop i can be
+    // merged if, for every operand, one step of o is extents[i] steps of i.
+    for (std::size_t i = retval.extents.size(); 1 < i--;) {
+        std::size_t const o = i - 1;
+        bool mergeable = true;
+        for (std::size_t k = 0; k < operands.size(); ++k) {
+            mergeable &= retval.strides[o][k] ==
+                retval.strides[i][k] * std::ptrdiff_t(retval.extents[i]);
+        }
+        if (mergeable) {
+            retval.extents[o] *= retval.extents[i];
+            retval.strides[o] = retval.strides[i];
+            retval.extents.erase(retval.extents.begin() + i);
+            retval.strides.erase(retval.strides.begin() + i);
+        }
+    }
+
+    if (retval.extents.empty()) {
+        retval.extents.push_back(1);
+        retval.strides.push_back(strides_t(operands.size(), 0));
+    }
+    return retval;
+}
+//]
+
+
+//[ tensor_assign
+// A tensor operand positioned at the start of one run of the innermost loop.
+template <typename T>
+struct strided_row
+{
+    T const * data;
+    std::ptrdiff_t stride;
+};
+
+// Replaces each tensor terminal with a strided_row, positioned for the
+// current iteration of the outer loops.  The operand for each terminal is
+// found by its address.
+struct bind_rows
+{
+    template <typename Tensor>
+    auto operator() (boost::yap::terminal_tag, Tensor const & t) ->
+        decltype(t.strides, boost::yap::make_terminal(strided_row<std::decay_t<decltype(*t.data())>>()))
+    {
+        using value_type = std::decay_t<decltype(*t.data())>;
+        std::size_t k = 1;
+        while (operands[k].tensor != &t) {
+            ++k;
+        }
+        return boost::yap::make_terminal(strided_row<value_type>{
+            static_cast<value_type const *>(operands[k].data) + offsets[k],
+            inner_strides[k]
+        });
+    }
+
+    std::vector<operand> const & operands;
+    strides_t const & offsets;
+    strides_t const & inner_strides;
+};
+
+struct take_nth
+{
+    template <typename T>
+    auto operator() (boost::yap::terminal_tag, strided_row<T> const & row)
+    { return boost::yap::make_terminal(row.data[std::ptrdiff_t(n) * row.stride]); }
+
+    std::size_t n;
+};
+
+// True iff some tensor operand of an expression has elements in the storage
+// of result, and so might be read after they have been overwritten.  The
+// one exception is result itself, when it keeps its shape; each of its
+// elements is then read only to compute the element written in its place.
+template <typename T>
+struct overlaps_result
+{
+    template <typename Expr>
+    auto operator() (bool overlap, Expr const & expr) ->
+        decltype(boost::yap::value(expr).strides, bool())
+    {
+        auto const & t = boost::yap::value(expr);
+        if (static_cast<void const *>(&t) == &result && result.shape == shape)
+            return overlap;
+
+        // The lowest and highest elements of t, relative to t.data().
+        std::ptrdiff_t lowest = 0;
+        std::ptrdiff_t highest = 0;
+        for (std::size_t d = 0; d < t.shape.size(); ++d) {
+            if (!t.shape[d])
+                return overlap;
+            std::ptrdiff_t const span = t.strides[d] * std::ptrdiff_t(t.shape[d] - 1);
+            (span < 0 ? lowest : highest) += span;
+        }
+        std::less<void const *> const less;
+        void const * const first = t.data() + lowest;
+        void const * const last = t.data() + highest + 1;
+        return overlap || (less(first, result.data() + result.elements.size()) && less(result.data(), last));
+    }
+
+    tensor<T> const & result;
+    shape_t const & shape;
+};
+
+// Assigns expr to result, which is resized to the broadcast shape of expr's
+// operands if necessary.  The result is operand 0 of the loop nest, so its
+// strides count towards the loop order too.
+//
+// If another operand shares elements with result, such as a transpose of
+// it, the expression is evaluated into a new tensor, which is then moved
+// into result.
+template <typename T, typename Expr>
+tensor<T> & assign (tensor<T> & result, Expr const & expr)
+{
+    shape_t const shape = boost::yap::fold(expr, shape_t(), broadcast_shape{});
+    if (boost::yap::fold(expr, false, overlaps_result<T>{result, shape})) {
+        tensor<T> temp(shape);
+        assign(temp, expr);
+        result = std::move(temp);
+        return result;
+    }
+    if (result.shape != shape)
+        result = tensor<T>(shape);
+    if (std::find(shape.begin(), shape.end(), std::size_t(0)) != shape.end())
+        return result;
+
+    std::vector<operand> const operands = boost::yap::fold(
+        expr,
+        std::vector<operand>{operand{&result, result.data(), result.strides}},
+        collect_operands{shape}
+    );
+    loop_nest const loops = plan_loops(shape, operands);
+
+    std::size_t const inner = loops.extents.size() - 1;
+    std::size_t const inner_extent = loops.extents[inner];
+    strides_t const & inner_strides = loops.strides[inner];
+
+    // An odometer over the outer loops, and each operand's offset at the
+    // current position.
+    shape_t index(inner, 0);
+    strides_t offsets(operands.size(), 0);
+    while (true) {
+        auto const rows = boost::yap::transform(expr, bind_rows{operands, offsets, inner_strides});
+        T * const out = result.data() + offsets[0];
+        for (std::size_t i = 0; i < inner_extent; ++i) {
+            out[std::ptrdiff_t(i) * inner_strides[0]] =
+                boost::yap::evaluate(boost::yap::transform(rows, take_nth{i}));
+        }
+
+        std::size_t l = inner;
+        while (l-- > 0) {
+            for (std::size_t k = 0; k < operands.size(); ++k) {
+                offsets[k] += loops.strides[l][k];
+            }
+            if (++index[l] < loops.extents[l])
+                break;
+            for (std::size_t k = 0; k < operands.size(); ++k) {
+                offsets[k] -= loops.strides[l][k] * std::ptrdiff_t(loops.extents[l]);
+            }
+            index[l] = 0;
+        }
+        if (l == std::size_t(-1))
+            break;
+    }
+    return result;
+}
+//]
+
+int main ()
+{
+    std::size_t const m = 3;
+    std::size_t const n = 4;
+
+    tensor<double> a({m, n});
+    tensor<double> b({n, m});
+    tensor<double> bias({n});
+    for (std::size_t i = 0; i < m; ++i) {
+        for (std::size_t j = 0; j < n; ++j) {
+            a({i, j}) = double(i * n + j);
+            b({j, i}) = 100.0 * double(j * m + i);
+        }
+    }
+    for (std::size_t j = 0; j < n; ++j) {
+        bias({j}) = 0.5 * double(j);
+    }
+
+    // transpose(b) is walked column by column, and bias is broadcast along
+    // the rows.
+    tensor<double> result;
+    assign(result, a + transpose(b) * 2.0 - bias);
+
+    for (std::size_t i = 0; i < m; ++i) {
+        for (std::size_t j = 0; j < n; ++j) {
+            std::cout << result({i, j}) << (j + 1 < n ? " " : "\n");
+            assert(result({i, j}) == a({i, j}) + b({j, i}) * 2.0 - bias({j}));
+        }
+    }
+
+    // Every operand is contiguous, so this is a single loop over 24 elements.
+    tensor<double> c({2, 3, 4}, 1.0);
+    tensor<double> d({2, 3, 4}, 2.0);
+    assert(plan_loops(c.shape, {operand{&c, c.data(), c.strides}, operand{&d, d.data(), d.strides}}).extents == shape_t{24});
+    assign(result, c * d + 1.0);
+    assert(result({1, 2, 3}) == 3.0);
+
+    // The result is row-major and the operand is column-major, so the two
+    // loops cannot be merged; the cheaper order is kept.
+    tensor<double> e;
+    assign(e, transpose(a) + 0.0);
+    assert(e.shape == (shape_t{n, m}));
+    assert(e({3, 2}) == a({2, 3}));
+
+    // A square tensor can be transposed in place; since the operand shares
+    // its elements with the result, it is evaluated into a new tensor first.
+    tensor<double> sq({n, n});
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = 0; j < n; ++j) {
+            sq({i, j}) = double(i * n + j);
+        }
+    }
+    assign(sq, transpose(sq) + 0.0);
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = 0; j < n; ++j) {
+            assert(sq({i, j}) == double(j * n + i));
+        }
+    }
+
+    // An expression with no elements assigns none.
+    tensor<double> empty({0, n});
+    assign(result, empty * 2.0);
+    assert(result.shape == (shape_t{0, n}) && result.elements.empty());
+
+    return 0;
+}
+//]
@@ -69,26 +69,17 @@ struct vec3 : vec3_terminal
     }
 };
 
-// This is a stateful transform that keeps a running count of the terminals it
-// has seen.
+// Adds one to a running count of the terminals seen by fold().  fold() only
+// calls this for the nodes it matches, so only vec3 terminals are counted.
 struct count_leaves_impl
 {
-    auto operator() (vec3_terminal const & expr)
-    {
-        value += 1;
-        return expr;
-    }
-
-    int value = 0;
+    int operator() (int count, vec3_terminal const &)
+    { return count + 1; }
 };
 
 template <typename Expr>
 int count_leaves (Expr const & expr)
-{
-    count_leaves_impl impl;
-    boost::yap::transform(expr, impl);
-    return impl.value;
-}
+{ return boost::yap::fold(expr, 0, count_leaves_impl{}); }
 
 
 int main()
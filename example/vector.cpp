@@ -16,30 +16,21 @@ struct take_nth
 };
 //]
 
-// A stateful transform that records whether all the std::vector<> terminals
-// it has seen are equal to the given size.
-struct equal_sizes_impl
+// A predicate that is true for each terminal of the given size.  It can only
+// be called with terminals whose values have a size(), such as std::vector<>s,
+// so all_of() skips all other nodes.
+struct equal_size
 {
-    template <typename T>
-    auto operator() (boost::yap::terminal_tag, std::vector<T> const & vec)
-    {
-        auto const expr_size = vec.size();
-        if (expr_size != size)
-            value = false;
-        return 0;
-    }
+    template <typename Expr>
+    auto operator() (Expr const & expr) -> decltype(boost::yap::value(expr).size() == 0)
+    { return boost::yap::value(expr).size() == size; }
 
     std::size_t const size;
-    bool value;
 };
 
 template <typename Expr>
 bool equal_sizes (std::size_t size, Expr const & expr)
-{
-    equal_sizes_impl impl{size, true};
-    boost::yap::transform(expr, impl);
-    return impl.value;
-}
+{ return boost::yap::all_of(expr, equal_size{size}); }
 
 
 // Assigns some expression e to the given vector by evaluating e elementwise,
@@ -0,0 +1,230 @@
+//[ zip
+#include <boost/yap/yap.hpp>
+
+#include <boost/hana/append.hpp>
+#include <boost/hana/concat.hpp>
+#include <boost/hana/fold_left.hpp>
+#include <boost/hana/for_each.hpp>
+#include <boost/hana/size.hpp>
+
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <list>
+#include <vector>
+
+
+//[ zip_extract
+// Splits an expression into a skeleton, in which the Ith container terminal
+// (counting from I = First, left to right) is replaced by placeholder I, and a
+// flat tuple of begin-iterators into those containers, in the same order.
+// Other terminals, such as scalars, stay in the skeleton as they are.
+//
+// Evaluating the skeleton with the dereferenced iterators as its arguments
+// then yields the current element of the expression.  Since the skeleton's
+// placeholders stand for the containers, expr must not contain placeholders
+// of its own; zipping one is a compile-time error.
+template <long long First, typename Expr>
+auto zip_expression (Expr const & expr);
+
+template <long long First, typename Expr, typename T>
+auto zip_terminal (Expr const &, T const & cont, int) ->
+    decltype(cont.begin(), boost::hana::make_tuple(boost::yap::make_terminal(boost::yap::placeholder<First>{}), boost::hana::make_tuple(cont.begin())))
+{
+    return boost::hana::make_tuple(
+        boost::yap::make_terminal(boost::yap::placeholder<First>{}),
+        boost::hana::make_tuple(cont.begin())
+    );
+}
+
+template <long long First, typename Expr, long long I>
+auto zip_terminal (Expr const & expr, boost::yap::placeholder<I> const &, int)
+{
+    static_assert(
+        sizeof(Expr) == 0,
+        "zip_expression() numbers its own placeholders, so the expression it "
+        "zips must not contain any."
+    );
+    return boost::hana::make_tuple(expr, boost::hana::make_tuple());
+}
+
+template <long long First, typename Expr, typename T>
+auto zip_terminal (Expr const & expr, T const &, long)
+{ return boost::hana::make_tuple(expr, boost::hana::make_tuple()); }
+
+template <long long First, typename Expr>
+auto zip_node (Expr const & expr, std::integral_constant<boost::yap::expr_kind, boost::yap::expr_kind::terminal>)
+{ return zip_terminal<First>(expr, boost::yap::value(expr), 0); }
+
+template <long long First, typename Expr>
+auto zip_node (Expr const & expr, std::integral_constant<boost::yap::expr_kind, boost::yap::expr_kind::expr_ref>)
+{ return zip_expression<First>(boost::yap::deref(expr)); }
+
+template <long long First, typename Expr, boost::yap::expr_kind Kind>
+auto zip_node (Expr const & expr, std::integral_constant<boost::yap::expr_kind, Kind>)
+{
+    using boost::hana::literals::operator""_c;
+    // Zip each child in turn, numbering its containers after those of the
+    // children before it.
+    auto zipped_children = boost::hana::fold_left(
+        expr.elements,
+        boost::hana::make_tuple(boost::hana::make_tuple(), boost::hana::make_tuple()),
+        [](auto const & state, auto const & child) {
+            using iterators = std::decay_t<decltype(state[1_c])>;
+            constexpr long long next = First + decltype(boost::hana::size(std::declval<iterators>()))::value;
+            auto zipped = zip_expression<next>(child);
+            return boost::hana::make_tuple(
+                boost::hana::append(state[0_c], std::move(zipped[0_c])),
+                boost::hana::concat(state[1_c], zipped[1_c])
+            );
+        }
+    );
+    // The children are moved into the new node, so that it holds them by
+    // value, not by reference.
+    return boost::hana::make_tuple(
+        boost::hana::unpack(std::move(zipped_children[0_c]), [](auto && ... children) {
+            return boost::yap::make_expression<boost::yap::expression, Kind>(std::move(children)...);
+        }),
+        zipped_children[1_c]
+    );
+}
+
+template <long long First, typename Expr>
+auto zip_expression (Expr const & expr)
+{ return zip_node<First>(expr, std::integral_constant<boost::yap::expr_kind, std::decay_t<Expr>::kind>{}); }
+//]
+
+
+//[ zip_engine
+// True iff every container terminal that the running value is folded over
+// has size elements.
+struct sizes_match
+{
+    template <typename Expr>
+    auto operator() (bool match, Expr const & expr) ->
+        decltype(boost::yap::value(expr).size(), bool())
+    { return match && boost::yap::value(expr).size() == size; }
+
+    std::size_t size;
+};
+
+// Evaluates an expression of sequences elementwise, calling op() with each
+// element of cont and the corresponding element of the expression.  The
+// expression is split once, before the loop; each iteration then only
+// dereferences and advances a flat tuple of iterators, and evaluates the same
+// skeleton.  No expression is built inside the loop, and the iterators are
+// not compared to their ends, so every container in the expression must be
+// as long as cont.
+template <typename Cont, typename Expr, typename Op>
+Cont & op_assign (Cont & cont, Expr const & e, Op && op)
+{
+    using boost::hana::literals::operator""_c;
+    assert(boost::yap::fold(boost::yap::as_expr(e), true, sizes_match{cont.size()}));
+    auto const zipped = zip_expression<1>(boost::yap::as_expr(e));
+    auto const & skeleton = zipped[0_c];
+    auto iterators = zipped[1_c];
+    for (auto && x : cont) {
+        op(x, boost::hana::unpack(iterators, [&skeleton](auto const & ... its) {
+            return boost::yap::evaluate(skeleton, *its...);
+        }));
+        boost::hana::for_each(iterators, [](auto & it) { ++it; });
+    }
+    return cont;
+}
+
+template <typename Cont, typename Expr>
+Cont & assign (Cont & cont, Expr const & expr)
+{
+    return op_assign(cont, expr, [](auto & cont_value, auto && expr_value) {
+        cont_value = std::forward<decltype(expr_value)>(expr_value);
+    });
+}
+
+template <typename Cont, typename Expr>
+Cont & operator+= (Cont & cont, Expr const & expr)
+{
+    return op_assign(cont, expr, [](auto & cont_value, auto && expr_value) {
+        cont_value += std::forward<decltype(expr_value)>(expr_value);
+    });
+}
+//]
+
+// A type trait that identifies std::vectors and std::lists.
+template <typename T>
+struct is_mixed : std::false_type {};
+
+template <typename T, typename A>
+struct is_mixed<std::vector<T, A>> : std::true_type {};
+
+template <typename T, typename A>
+struct is_mixed<std::list<T, A>> : std::true_type {};
+
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(multiplies, boost::yap::expression, is_mixed); // *
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(divides, boost::yap::expression, is_mixed); // /
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(plus, boost::yap::expression, is_mixed); // +
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(minus, boost::yap::expression, is_mixed); // -
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(less, boost::yap::expression, is_mixed); // <
+
+namespace user {
+
+    struct sin_tag {};
+
+    // Customization points still apply, since the skeleton is evaluated by
+    // evaluate().
+    template <typename T>
+    inline auto eval_call (sin_tag, T && x)
+    { return std::sin(x); }
+
+}
+
+int main ()
+{
+    std::size_t const n = 1000000;
+
+    std::vector<double> a(n);
+    std::list<double> b;
+    std::vector<int> c(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        a[i] = 0.001 * double(i);
+        b.push_back(double(i % 100));
+        c[i] = int(i % 7);
+    }
+
+    using clock = std::chrono::steady_clock;
+    auto const ms_since = [](clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(clock::now() - start).count();
+    };
+
+    std::list<double> result(n);
+    clock::time_point start = clock::now();
+    assign(result, a * b + c / 2.0 - 1.0);
+    std::cout << "zipped: " << ms_since(start) << " ms\n";
+
+    std::list<double> expected(n);
+    start = clock::now();
+    {
+        auto a_it = a.begin();
+        auto b_it = b.begin();
+        auto c_it = c.begin();
+        for (double & x : expected) {
+            x = *a_it++ * *b_it++ + *c_it++ / 2.0 - 1.0;
+        }
+    }
+    std::cout << "hand-written: " << ms_since(start) << " ms\n";
+    assert(result == expected);
+
+    auto sin = boost::yap::make_terminal(user::sin_tag{});
+    result += if_else(c < 3, sin(a), b);
+    auto b_it = b.begin();
+    auto result_it = result.begin();
+    auto expected_it = expected.begin();
+    for (std::size_t i = 0; i < n; ++i, ++b_it, ++result_it, ++expected_it) {
+        double const x = *expected_it + (c[i] < 3 ? std::sin(a[i]) : *b_it);
+        assert(*result_it == x);
+        (void)x;
+    }
+
+    return 0;
+}
+//]
@@ -0,0 +1,155 @@
+// Measures the cost of building the eval_as_yap_expr_4x expression from
+// arithmetic_perf.cpp separately from the cost of evaluating it.
+
+#include <boost/yap/expression.hpp>
+
+#include <chrono>
+#include <iostream>
+
+#include <benchmark/benchmark.h>
+
+
+template <typename T>
+using term = boost::yap::terminal<boost::yap::expression, T>;
+
+namespace yap = boost::yap;
+namespace bh = boost::hana;
+
+
+namespace user {
+
+    struct number
+    {
+        double value;
+
+        friend number operator+ (number lhs, number rhs)
+        { return number{lhs.value + rhs.value}; }
+
+        friend number operator* (number lhs, number rhs)
+        { return number{lhs.value * rhs.value}; }
+    };
+
+}
+
+double get_noise ()
+{
+    auto const start_time = std::chrono::high_resolution_clock::now();
+    auto const start_time_ns = std::chrono::time_point_cast<std::chrono::nanoseconds>(start_time);
+    return 1.0 * start_time_ns.time_since_epoch().count();
+}
+
+
+user::number g_a{get_noise()};
+user::number g_x{get_noise()};
+user::number g_y{get_noise()};
+
+// The same expression as eval_as_yap_expr_4x in arithmetic_perf.cpp, with
+// its terminals held by reference.
+template <typename A, typename X, typename Y>
+auto build_4x (A & a, X & x, Y & y)
+{
+    return
+        (a * x + y) * (a * x + y) + (a * x + y) +
+        (a * x + y) * (a * x + y) + (a * x + y) +
+        (a * x + y) * (a * x + y) + (a * x + y) +
+        (a * x + y) * (a * x + y) + (a * x + y)
+        ;
+}
+
+// The same expression, with every terminal held by value.
+auto build_4x_by_value (user::number a, user::number x, user::number y)
+{
+    return
+        (term<user::number>{{a}} * term<user::number>{{x}} + term<user::number>{{y}}) *
+        (term<user::number>{{a}} * term<user::number>{{x}} + term<user::number>{{y}}) +
+        (term<user::number>{{a}} * term<user::number>{{x}} + term<user::number>{{y}}) +
+        (term<user::number>{{a}} * term<user::number>{{x}} + term<user::number>{{y}}) *
+        (term<user::number>{{a}} * term<user::number>{{x}} + term<user::number>{{y}}) +
+        (term<user::number>{{a}} * term<user::number>{{x}} + term<user::number>{{y}}) +
+        (term<user::number>{{a}} * term<user::number>{{x}} + term<user::number>{{y}}) *
+        (term<user::number>{{a}} * term<user::number>{{x}} + term<user::number>{{y}}) +
+        (term<user::number>{{a}} * term<user::number>{{x}} + term<user::number>{{y}}) +
+        (term<user::number>{{a}} * term<user::number>{{x}} + term<user::number>{{y}}) *
+        (term<user::number>{{a}} * term<user::number>{{x}} + term<user::number>{{y}}) +
+        (term<user::number>{{a}} * term<user::number>{{x}} + term<user::number>{{y}})
+        ;
+}
+
+
+void BM_build_4x (benchmark::State & state)
+{
+    term<user::number> a{{g_a}};
+    term<user::number> x{{g_x}};
+    term<user::number> y{{g_y}};
+    while (state.KeepRunning()) {
+        auto expr = build_4x(a, x, y);
+        benchmark::DoNotOptimize(expr);
+    }
+}
+
+void BM_eval_4x (benchmark::State & state)
+{
+    term<user::number> a{{g_a}};
+    term<user::number> x{{g_x}};
+    term<user::number> y{{g_y}};
+    auto expr = build_4x(a, x, y);
+    double d = 0;
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(expr);
+        user::number const n = yap::evaluate(expr);
+        d += n.value;
+    }
+    std::cout << "Sum of doubles=" << d << "\n";
+}
+
+void BM_build_and_eval_4x (benchmark::State & state)
+{
+    term<user::number> a{{g_a}};
+    term<user::number> x{{g_x}};
+    term<user::number> y{{g_y}};
+    double d = 0;
+    while (state.KeepRunning()) {
+        user::number const n = yap::evaluate(build_4x(a, x, y));
+        d += n.value;
+    }
+    std::cout << "Sum of doubles=" << d << "\n";
+}
+
+void BM_build_4x_by_value (benchmark::State & state)
+{
+    while (state.KeepRunning()) {
+        auto expr = build_4x_by_value(g_a, g_x, g_y);
+        benchmark::DoNotOptimize(expr);
+    }
+}
+
+void BM_eval_4x_by_value (benchmark::State & state)
+{
+    auto expr = build_4x_by_value(g_a, g_x, g_y);
+    double d = 0;
+    while (state.KeepRunning()) {
+        benchmark::DoNotOptimize(expr);
+        user::number const n = yap::evaluate(expr);
+        d += n.value;
+    }
+    std::cout << "Sum of doubles=" << d << "\n";
+}
+
+void BM_build_and_eval_4x_by_value (benchmark::State & state)
+{
+    double d = 0;
+    while (state.KeepRunning()) {
+        user::number const n = yap::evaluate(build_4x_by_value(g_a, g_x, g_y));
+        d += n.value;
+    }
+    std::cout << "Sum of doubles=" << d << "\n";
+}
+
+BENCHMARK(BM_build_4x);
+BENCHMARK(BM_eval_4x);
+BENCHMARK(BM_build_and_eval_4x);
+BENCHMARK(BM_build_4x_by_value);
+BENCHMARK(BM_eval_4x_by_value);
+BENCHMARK(BM_build_and_eval_4x_by_value);
+
+BENCHMARK_MAIN()
@@ -0,0 +1,131 @@
+// This file is meant to be timed as it compiles, not as it runs.  The
+// transform_compile_perf_timing target reports -ftime-report for it, as a
+// baseline for the compile-time cost of transform() over tag and expression
+// transforms.
+
+#include <boost/yap/expression.hpp>
+
+#include <iostream>
+
+
+template <typename T>
+using term = boost::yap::terminal<boost::yap::expression, T>;
+
+namespace yap = boost::yap;
+namespace bh = boost::hana;
+
+
+namespace user {
+
+    struct number
+    {
+        double value;
+
+        friend number operator+ (number lhs, number rhs)
+        { return number{lhs.value + rhs.value}; }
+
+        friend number operator- (number lhs, number rhs)
+        { return number{lhs.value - rhs.value}; }
+
+        friend number operator* (number lhs, number rhs)
+        { return number{lhs.value * rhs.value}; }
+
+        friend number operator- (number n)
+        { return number{-n.value}; }
+    };
+
+    struct eval_xform_tag
+    {
+        number operator() (yap::terminal_tag, number n)
+        { return n; }
+
+        template <typename Expr>
+        number operator() (yap::negate_tag, Expr const & expr)
+        { return -yap::transform(expr, *this); }
+
+        template <typename Expr1, typename Expr2>
+        number operator() (yap::plus_tag, Expr1 const & lhs, Expr2 const & rhs)
+        { return yap::transform(lhs, *this) + yap::transform(rhs, *this); }
+
+        template <typename Expr1, typename Expr2>
+        number operator() (yap::minus_tag, Expr1 const & lhs, Expr2 const & rhs)
+        { return yap::transform(lhs, *this) - yap::transform(rhs, *this); }
+
+        template <typename Expr1, typename Expr2>
+        number operator() (yap::multiplies_tag, Expr1 const & lhs, Expr2 const & rhs)
+        { return yap::transform(lhs, *this) * yap::transform(rhs, *this); }
+    };
+
+    struct eval_xform_expr
+    {
+        number operator() (term<number> const & expr)
+        { return yap::value(expr); }
+
+        template <typename Expr>
+        number operator() (yap::expression<yap::expr_kind::negate, bh::tuple<Expr>> const & expr)
+        { return -yap::transform(yap::value(expr), *this); }
+
+        template <typename Expr1, typename Expr2>
+        number operator() (yap::expression<yap::expr_kind::plus, bh::tuple<Expr1, Expr2>> const & expr)
+        { return yap::transform(yap::left(expr), *this) + yap::transform(yap::right(expr), *this); }
+
+        template <typename Expr1, typename Expr2>
+        number operator() (yap::expression<yap::expr_kind::minus, bh::tuple<Expr1, Expr2>> const & expr)
+        { return yap::transform(yap::left(expr), *this) - yap::transform(yap::right(expr), *this); }
+
+        template <typename Expr1, typename Expr2>
+        number operator() (yap::expression<yap::expr_kind::multiplies, bh::tuple<Expr1, Expr2>> const & expr)
+        { return yap::transform(yap::left(expr), *this) * yap::transform(yap::right(expr), *this); }
+    };
+
+    struct double_terminals_xform_tag
+    {
+        auto operator() (yap::terminal_tag, number n)
+        { return yap::make_terminal(n * number{2.0}); }
+    };
+
+    struct double_terminals_xform_expr
+    {
+        auto operator() (term<number> const & expr)
+        { return yap::make_terminal(yap::value(expr) * number{2.0}); }
+    };
+
+}
+
+template <typename Expr>
+double transform_all (Expr const & expr)
+{
+    double retval = 0.0;
+    retval += yap::transform(expr, user::eval_xform_tag{}).value;
+    retval += yap::transform(expr, user::eval_xform_expr{}).value;
+    retval += yap::evaluate(yap::transform(expr, user::double_terminals_xform_tag{})).value;
+    retval += yap::evaluate(yap::transform(expr, user::double_terminals_xform_expr{})).value;
+    return retval;
+}
+
+int main ()
+{
+    term<user::number> a{{1.0}};
+    term<user::number> x{{42.0}};
+    term<user::number> y{{3.0}};
+
+    double result = 0.0;
+
+    result += transform_all(a * x + y);
+    result += transform_all(-(a * x + y));
+    result += transform_all((a * x + y) * (a * x + y) + (a * x + y));
+    result += transform_all((a * x - y) * (a - x * y) + -(a * x + y) * (x - y));
+    result += transform_all(a * (x + y * (a - x * (y + a * (x - y * (a + x))))));
+    result += transform_all(((((a + x) * y - a) * x + y) * a - x) * y);
+    result += transform_all(
+        (a * x + y) * (a * x + y) * (a * x + y) * (a * x + y) +
+        (a - x - y) * (a - x - y) * (a - x - y) * (a - x - y)
+    );
+    result += transform_all(
+        -(-(-(a * x + y))) * -(-(a - x * y)) + -(a * -(x * -y))
+    );
+
+    std::cout << result << "\n";
+
+    return 0;
+}
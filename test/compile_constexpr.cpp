@@ -0,0 +1,112 @@
+#include <boost/yap/expression.hpp>
+
+#include <array>
+#include <utility>
+
+
+template <typename T>
+using term = boost::yap::terminal<boost::yap::expression, T>;
+
+namespace yap = boost::yap;
+namespace bh = boost::hana;
+
+
+namespace {
+
+    struct point
+    {
+        int x;
+        int y;
+    };
+
+    constexpr point operator+ (point lhs, point rhs)
+    { return point{lhs.x + rhs.x, lhs.y + rhs.y}; }
+
+    constexpr point operator* (int s, point p)
+    { return point{s * p.x, s * p.y}; }
+
+    struct double_ints
+    {
+        constexpr auto operator() (yap::terminal_tag, int i) const
+        { return yap::make_terminal(2 * i); }
+    };
+
+    struct plus_to_minus
+    {
+        template <typename Expr1, typename Expr2>
+        constexpr auto operator() (yap::expression<yap::expr_kind::plus, bh::tuple<Expr1, Expr2>> const & expr) const
+        {
+            return yap::make_expression<yap::expr_kind::minus>(
+                yap::transform(yap::left(expr), *this),
+                yap::transform(yap::right(expr), *this)
+            );
+        }
+    };
+
+    struct count_terminals
+    {
+        constexpr int operator() (int n, term<int> const &) const
+        { return n + 1; }
+    };
+
+    constexpr term<int> two{2};
+    constexpr term<int> three{3};
+
+    template <typename Expr, std::size_t ...I>
+    constexpr std::array<int, sizeof...(I)> make_table (Expr const & expr, std::index_sequence<I...>)
+    { return {{yap::evaluate(expr, int(I))...}}; }
+
+}
+
+
+void compile_constexpr ()
+{
+    using namespace boost::yap::literals;
+
+    {
+        constexpr term<int> unity{1};
+        static_assert(yap::value(unity) == 1, "");
+        static_assert(yap::evaluate(unity) == 1, "");
+        static_assert(yap::evaluate(yap::make_terminal(7)) == 7, "");
+    }
+
+    {
+        // Terminals with static storage can be captured by reference.
+        constexpr auto expr = two * three + 1;
+        static_assert(yap::evaluate(expr) == 7, "");
+        static_assert(yap::evaluate(yap::left(expr)) == 6, "");
+        static_assert(yap::evaluate(-expr) == -7, "");
+        static_assert(yap::evaluate(two * three + 1 < 10), "");
+    }
+
+    {
+        constexpr auto expr = term<int>{2} * term<int>{3} + term<int>{1};
+        static_assert(yap::evaluate(expr) == 7, "");
+        static_assert(yap::evaluate(yap::make_expression<yap::expr_kind::minus>(expr, 1)) == 6, "");
+        static_assert(yap::evaluate_as<long>(expr) == 7, "");
+    }
+
+    {
+        constexpr auto expr = 1_p * 1_p + 2_p;
+        static_assert(yap::evaluate(expr, 3, 4) == 13, "");
+        static_assert(yap::make_expression_function(1_p - 2_p)(9, 4) == 5, "");
+
+        constexpr std::array<int, 5> table = make_table(1_p * 1_p + 1, std::make_index_sequence<5>{});
+        static_assert(table[0] == 1 && table[2] == 5 && table[4] == 17, "");
+    }
+
+    {
+        constexpr auto expr = term<int>{2} * term<point>{{1, 2}} + term<point>{{3, 4}};
+        static_assert(yap::evaluate(expr).x == 5, "");
+        static_assert(yap::evaluate(expr).y == 8, "");
+    }
+
+    {
+        // A transform may capture subexpressions of its input by reference,
+        // so the input needs static storage too.
+        static constexpr auto expr = term<int>{2} * term<int>{3} + 1;
+        static_assert(yap::evaluate(yap::transform(expr, double_ints{})) == 26, "");
+        static_assert(yap::evaluate(yap::transform(expr, plus_to_minus{})) == 5, "");
+        static_assert(yap::fold(expr, 0, count_terminals{}) == 3, "");
+    }
+}
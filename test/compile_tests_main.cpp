@@ -1,5 +1,6 @@
 void compile_is_expr();
 void compile_const_term();
+void compile_constexpr();
 void compile_copy_only_types();
 void compile_move_only_types();
 void compile_placeholders();
@@ -13,6 +14,7 @@ int main ()
 {
     compile_is_expr();
     compile_const_term();
+    compile_constexpr();
     compile_copy_only_types();
     compile_move_only_types();
     compile_placeholders();
@@ -0,0 +1,130 @@
+#include <boost/yap/expression.hpp>
+
+#include <gtest/gtest.h>
+
+
+template <typename T>
+using term = boost::yap::terminal<boost::yap::expression, T>;
+
+namespace yap = boost::yap;
+namespace bh = boost::hana;
+
+
+int moves = 0;
+int copies = 0;
+
+struct counted
+{
+    counted () {}
+    counted (counted const &) { ++copies; }
+    counted (counted &&) { ++moves; }
+};
+
+void reset_counts ()
+{ moves = copies = 0; }
+
+
+template <boost::yap::expr_kind Kind, typename Tuple>
+struct user_expr
+{
+    static boost::yap::expr_kind const kind = Kind;
+
+    Tuple elements;
+
+    BOOST_YAP_USER_BINARY_OPERATOR_MEMBER(plus, ::user_expr)
+};
+
+template <typename T>
+using user_term = boost::yap::terminal<user_expr, T>;
+
+
+TEST(construction_moves, test_single_node)
+{
+    term<counted> lvalue;
+
+    // Each rvalue terminal is moved twice: into the new node's tuple, and
+    // then, with the tuple, into the node's elements.
+
+    reset_counts();
+    {
+        auto expr = term<counted>{} + lvalue;
+        EXPECT_EQ(moves, 2);
+        (void)expr;
+    }
+
+    reset_counts();
+    {
+        auto expr = lvalue + term<counted>{};
+        EXPECT_EQ(moves, 2);
+        (void)expr;
+    }
+
+    reset_counts();
+    {
+        auto expr = term<counted>{} + term<counted>{};
+        EXPECT_EQ(moves, 4);
+        (void)expr;
+    }
+
+    reset_counts();
+    {
+        auto expr = yap::make_expression<yap::expr_kind::plus>(term<counted>{}, lvalue);
+        EXPECT_EQ(moves, 2);
+        (void)expr;
+    }
+
+    EXPECT_EQ(copies, 0);
+}
+
+TEST(construction_moves, test_chains)
+{
+    // Each terminal is moved twice per node above it, since each node moves
+    // its whole subtree: the number of moves grows with the square of the
+    // length of a chain.
+    reset_counts();
+    {
+        auto expr = term<counted>{} + term<counted>{} + term<counted>{} + term<counted>{};
+        EXPECT_EQ(moves, 2 * (3 + 3 + 2 + 1));
+        (void)expr;
+    }
+
+    reset_counts();
+    {
+        auto expr = term<counted>{} + (term<counted>{} + (term<counted>{} + term<counted>{}));
+        EXPECT_EQ(moves, 2 * (1 + 2 + 3 + 3));
+        (void)expr;
+    }
+
+    EXPECT_EQ(copies, 0);
+}
+
+TEST(construction_moves, test_user_expr)
+{
+    user_term<counted> lvalue;
+
+    // user_expr is an aggregate, so its elements are initialized directly
+    // from the new tuple, and each terminal is moved once per node.
+
+    reset_counts();
+    {
+        auto expr = user_term<counted>{} + lvalue;
+        EXPECT_EQ(moves, 1);
+        (void)expr;
+    }
+
+    reset_counts();
+    {
+        auto expr = lvalue + user_term<counted>{};
+        EXPECT_EQ(moves, 1);
+        (void)expr;
+    }
+
+    reset_counts();
+    {
+        auto expr = user_term<counted>{} + user_term<counted>{} + user_term<counted>{};
+        EXPECT_EQ(moves, 2 + 2 + 1);
+        (void)expr;
+    }
+
+    EXPECT_EQ(copies, 0);
+}
@@ -0,0 +1,180 @@
+#include <boost/yap/expression.hpp>
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+
+template <typename T>
+using term = boost::yap::terminal<boost::yap::expression, T>;
+
+namespace yap = boost::yap;
+namespace bh = boost::hana;
+
+
+template <boost::yap::expr_kind Kind, typename Tuple>
+struct user_expr
+{
+    static boost::yap::expr_kind const kind = Kind;
+
+    Tuple elements;
+
+    BOOST_YAP_USER_BINARY_OPERATOR_MEMBER(plus, ::user_expr)
+};
+
+template <typename T>
+using user_term = boost::yap::terminal<user_expr, T>;
+
+
+struct count_terminals
+{
+    template <template <yap::expr_kind, class> class ExprTemplate, typename T>
+    int operator() (int n, ExprTemplate<yap::expr_kind::terminal, bh::tuple<T>> const &)
+    { return n + 1; }
+};
+
+struct sum_doubles
+{
+    double operator() (double sum, term<double> const & expr)
+    { return sum + yap::value(expr); }
+};
+
+struct record_kinds
+{
+    template <typename Expr>
+    std::vector<yap::expr_kind> operator() (std::vector<yap::expr_kind> kinds, Expr const & expr)
+    {
+        yap::expr_kind const kind = Expr::kind;
+        kinds.push_back(kind);
+        return kinds;
+    }
+};
+
+struct int_to_double
+{
+    double operator() (int n, term<double> const & expr)
+    { return n + yap::value(expr); }
+};
+
+struct positive
+{
+    bool operator() (term<double> const & expr)
+    {
+        ++calls;
+        return 0.0 < yap::value(expr);
+    }
+
+    int & calls;
+};
+
+
+TEST(fold, test_fold)
+{
+    term<double> a{1.0};
+    term<double> x{2.0};
+
+    {
+        EXPECT_EQ(yap::fold(a, 0, count_terminals{}), 1);
+        EXPECT_EQ(yap::fold(a * x + term<double>{3.0}, 0, count_terminals{}), 3);
+        EXPECT_EQ(yap::fold(a * x + 3, 0, count_terminals{}), 3);
+        EXPECT_EQ(yap::fold(-(a * x), 0, count_terminals{}), 2);
+    }
+
+    {
+        // Reference expressions are transparent, and nodes that fn cannot be
+        // called with are skipped.
+        auto expr = a * x;
+        EXPECT_EQ(yap::fold(expr + expr + 3, 0.0, sum_doubles{}), 6.0);
+    }
+
+    {
+        term<std::vector<int>> v{std::vector<int>{}};
+        auto expr = a * x + v;
+        EXPECT_EQ(yap::fold(expr, 0.0, sum_doubles{}), 3.0);
+    }
+}
+
+TEST(fold, test_fold_order)
+{
+    term<double> a{1.0};
+    term<double> x{2.0};
+
+    auto expr = a * x + -a;
+    auto const kinds = yap::fold(expr, std::vector<yap::expr_kind>{}, record_kinds{});
+    std::vector<yap::expr_kind> const expected = {
+        yap::expr_kind::plus,
+        yap::expr_kind::multiplies,
+        yap::expr_kind::terminal,
+        yap::expr_kind::terminal,
+        yap::expr_kind::negate,
+        yap::expr_kind::terminal,
+    };
+    EXPECT_EQ(kinds, expected);
+}
+
+TEST(fold, test_fold_state_type)
+{
+    term<double> a{1.5};
+
+    auto result = yap::fold(a, 1, int_to_double{});
+    EXPECT_TRUE((std::is_same<decltype(result), double>::value));
+    EXPECT_EQ(result, 2.5);
+
+    auto unchanged = yap::fold(term<int>{1}, 1, int_to_double{});
+    EXPECT_TRUE((std::is_same<decltype(unchanged), int>::value));
+    EXPECT_EQ(unchanged, 1);
+}
+
+TEST(fold, test_any_of_all_of)
+{
+    term<double> a{1.0};
+    term<double> x{-2.0};
+    term<double> y{3.0};
+
+    int calls = 0;
+
+    EXPECT_TRUE(yap::all_of(a * y + 4, positive{calls}));
+    EXPECT_FALSE(yap::all_of(a * x + y, positive{calls}));
+    EXPECT_TRUE(yap::any_of(a * x + y, positive{calls}));
+    EXPECT_FALSE(yap::any_of(x * x + 4, positive{calls}));
+
+    // No node can be tested.
+    EXPECT_TRUE(yap::all_of(term<int>{1} + 2, positive{calls}));
+    EXPECT_FALSE(yap::any_of(term<int>{1} + 2, positive{calls}));
+
+    // Nonterminals can be tested too.
+    EXPECT_TRUE(yap::any_of(a * x + y, [](auto const & expr) {
+        return yap::detail::remove_cv_ref_t<decltype(expr)>::kind == yap::expr_kind::multiplies;
+    }));
+    EXPECT_FALSE(yap::any_of(a * x + y, [](auto const & expr) {
+        return yap::detail::remove_cv_ref_t<decltype(expr)>::kind == yap::expr_kind::minus;
+    }));
+}
+
+TEST(fold, test_early_exit)
+{
+    term<double> a{1.0};
+    term<double> x{-2.0};
+    term<double> y{3.0};
+
+    int calls = 0;
+    EXPECT_FALSE(yap::all_of(x * a + y * y, positive{calls}));
+    EXPECT_EQ(calls, 1);
+
+    calls = 0;
+    EXPECT_TRUE(yap::any_of(x * a + y * y, positive{calls}));
+    EXPECT_EQ(calls, 2);
+
+    calls = 0;
+    EXPECT_TRUE(yap::all_of(a * y + y * a, positive{calls}));
+    EXPECT_EQ(calls, 4);
+}
+
+TEST(fold, test_user_expr)
+{
+    user_term<double> a{bh::make_tuple(1.0)};
+    user_term<double> x{bh::make_tuple(2.0)};
+
+    EXPECT_EQ(yap::fold(a + x + a, 0, count_terminals{}), 3);
+    EXPECT_TRUE(yap::all_of(a + x, [](auto const & expr) { return true; }));
+}
@@ -0,0 +1,126 @@
+#include <boost/yap/expression.hpp>
+#include <boost/yap/lazy_terminal.hpp>
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+
+template <typename T>
+using term = boost::yap::terminal<boost::yap::expression, T>;
+
+namespace yap = boost::yap;
+namespace bh = boost::hana;
+
+
+struct expensive
+{
+    double operator() () const
+    {
+        ++calls;
+        return 4.0;
+    }
+
+    std::atomic<int> & calls;
+};
+
+struct double_doubles
+{
+    auto operator() (yap::terminal_tag, double d)
+    { return yap::make_terminal(2.0 * d); }
+};
+
+
+TEST(lazy_terminal, test_evaluate)
+{
+    std::atomic<int> calls{0};
+    auto lazy = yap::make_lazy_terminal<yap::expression>(expensive{calls});
+    EXPECT_TRUE((std::is_same<
+        decltype(lazy),
+        yap::lazy_terminal<yap::expression, expensive>
+    >::value));
+
+    EXPECT_FALSE(yap::value(lazy).computed());
+    EXPECT_EQ(calls, 0);
+
+    term<double> x{{2.0}};
+    auto expr = lazy * x + lazy;
+    EXPECT_EQ(calls, 0);
+
+    EXPECT_EQ(yap::evaluate(expr), 12.0);
+    EXPECT_EQ(calls, 1);
+    EXPECT_TRUE(yap::value(lazy).computed());
+
+    EXPECT_EQ(yap::evaluate(expr), 12.0);
+    EXPECT_EQ(yap::evaluate(lazy - x), 2.0);
+    EXPECT_EQ(calls, 1);
+
+    {
+        // Copies share the cached result.
+        auto copy = lazy;
+        EXPECT_EQ(yap::evaluate(std::move(copy) * 2.0), 8.0);
+        EXPECT_EQ(calls, 1);
+    }
+
+    {
+        double const & result = yap::evaluate(lazy);
+        EXPECT_EQ(result, 4.0);
+        double const & value = yap::value(lazy);
+        EXPECT_EQ(std::addressof(value), std::addressof(result));
+    }
+}
+
+TEST(lazy_terminal, test_transform)
+{
+    std::atomic<int> calls{0};
+    auto lazy = yap::make_lazy_terminal<yap::expression>(expensive{calls});
+    term<double> x{{2.0}};
+
+    auto transformed = yap::transform(lazy * x, double_doubles{});
+    EXPECT_EQ(calls, 1);
+    EXPECT_EQ(yap::evaluate(transformed), 32.0);
+    EXPECT_EQ(yap::evaluate(yap::transform(lazy + 1.0, double_doubles{})), 10.0);
+    EXPECT_EQ(calls, 1);
+}
+
+TEST(lazy_terminal, test_threads)
+{
+    std::atomic<int> calls{0};
+    auto lazy = yap::make_lazy_terminal<yap::expression>(expensive{calls});
+    term<double> x{{2.0}};
+
+    std::vector<double> results(8);
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        threads.emplace_back([&, i] {
+            auto expr = lazy * x + double(i);
+            results[i] = yap::evaluate(expr);
+        });
+    }
+    for (auto & thread : threads) {
+        thread.join();
+    }
+
+    EXPECT_EQ(calls, 1);
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        EXPECT_EQ(results[i], 8.0 + i);
+    }
+}
+
+TEST(lazy_terminal, test_throwing_callable)
+{
+    int attempts = 0;
+    auto lazy = yap::make_lazy_terminal<yap::expression>([&attempts] {
+        if (++attempts == 1)
+            throw std::runtime_error("Not yet!");
+        return 3;
+    });
+
+    EXPECT_THROW(yap::evaluate(lazy + 1), std::runtime_error);
+    EXPECT_FALSE(yap::value(lazy).computed());
+    EXPECT_EQ(yap::evaluate(lazy + 1), 4);
+    EXPECT_EQ(yap::evaluate(lazy + 1), 4);
+    EXPECT_EQ(attempts, 2);
+}
@@ -0,0 +1,200 @@
+#include <boost/yap/expression.hpp>
+#include <boost/yap/rewrite.hpp>
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+
+template <typename T>
+using term = boost::yap::terminal<boost::yap::expression, T>;
+
+template <typename T>
+using ref = boost::yap::expression_ref<boost::yap::expression, T>;
+
+namespace yap = boost::yap;
+namespace bh = boost::hana;
+
+
+template <boost::yap::expr_kind Kind, typename Tuple>
+struct user_expr
+{
+    static boost::yap::expr_kind const kind = Kind;
+
+    Tuple elements;
+
+    BOOST_YAP_USER_BINARY_OPERATOR_MEMBER(plus, ::user_expr)
+};
+
+template <typename T>
+using user_term = boost::yap::terminal<user_expr, T>;
+
+struct zero_t {};
+struct one_t {};
+struct fma_t {};
+
+double eval_call (fma_t, double a, double b, double c)
+{ return a * b + c; }
+
+
+TEST(rewrite, test_no_match)
+{
+    using namespace yap::literals;
+
+    term<double> x{2.0};
+    term<double> y{3.0};
+    auto expr = x + y;
+
+    auto const times_one = yap::rule(1_p * term<one_t>{}, 1_p);
+
+    // Nothing matches, so the expression itself comes back.
+    decltype(auto) result = yap::rewrite(expr, times_one);
+    EXPECT_TRUE((std::is_same<decltype(result), decltype(expr) &>::value));
+    EXPECT_EQ(std::addressof(result), std::addressof(expr));
+
+    // An rvalue is returned by value, not as a reference to the temporary.
+    decltype(auto) moved = yap::rewrite(x + y, times_one);
+    EXPECT_TRUE((std::is_same<decltype(moved), decltype(expr)>::value));
+    EXPECT_EQ(yap::evaluate(moved), 5.0);
+}
+
+TEST(rewrite, test_simplify)
+{
+    using namespace yap::literals;
+
+    term<double> x{2.0};
+    term<one_t> one;
+    term<zero_t> zero;
+
+    auto const times_one = yap::rule(1_p * term<one_t>{}, 1_p);
+    auto const plus_zero = yap::rule(1_p + term<zero_t>{}, 1_p);
+
+    {
+        auto result = yap::rewrite(x * one, times_one, plus_zero);
+        EXPECT_TRUE((std::is_same<decltype(result), ref<term<double> &>>::value));
+        EXPECT_EQ(yap::evaluate(result), 2.0);
+    }
+
+    {
+        // Rewriting the operands exposes new matches higher up, all the way
+        // to the root.
+        auto result = yap::rewrite(((x * one + zero) * one + zero) * one, times_one, plus_zero);
+        EXPECT_TRUE((std::is_same<decltype(result), ref<term<double> &>>::value));
+        EXPECT_EQ(yap::evaluate(result), 2.0);
+    }
+
+    {
+        term<double> y{3.0};
+        auto result = yap::rewrite(x * one + y * (one * one), times_one, plus_zero);
+        EXPECT_EQ(yap::evaluate(result), 5.0);
+    }
+}
+
+TEST(rewrite, test_fixpoint)
+{
+    using namespace yap::literals;
+
+    term<double> x{2.0};
+
+    auto const double_negation = yap::rule(-(-1_p), 1_p);
+
+    auto result = yap::rewrite(-(-(-(-(-x)))), double_negation);
+    EXPECT_TRUE((std::is_same<decltype(result), yap::expression<yap::expr_kind::negate, bh::tuple<ref<term<double> &>>>>::value));
+    EXPECT_EQ(yap::evaluate(result), -2.0);
+}
+
+TEST(rewrite, test_rule_order)
+{
+    using namespace yap::literals;
+
+    term<double> x{2.0};
+    term<double> y{3.0};
+
+    auto const plus_to_minus = yap::rule(1_p + 2_p, 1_p - 2_p);
+    auto const plus_to_times = yap::rule(1_p + 2_p, 1_p * 2_p);
+
+    EXPECT_EQ(yap::evaluate(yap::rewrite(x + y, plus_to_minus, plus_to_times)), -1.0);
+    EXPECT_EQ(yap::evaluate(yap::rewrite(x + y, plus_to_times, plus_to_minus)), 6.0);
+}
+
+TEST(rewrite, test_replacement_terminals_and_repeats)
+{
+    using namespace yap::literals;
+
+    term<double> x{3.0};
+
+    // Placeholders may appear any number of times in a replacement, and
+    // non-placeholder terminals in the replacement are copied into the
+    // result.
+    auto const square_plus_one = yap::rule(
+        -1_p,
+        1_p * 1_p + term<double>{1.0}
+    );
+
+    auto result = yap::rewrite(-(x + term<double>{1.0}), square_plus_one);
+    EXPECT_EQ(yap::evaluate(result), 17.0);
+}
+
+TEST(rewrite, test_callable_replacement)
+{
+    using namespace yap::literals;
+
+    term<double> a{2.0};
+    term<double> x{3.0};
+    term<double> y{4.0};
+
+    // Fuse multiply-adds into a single call.
+    auto const fuse = yap::rule(
+        1_p * 2_p + 3_p,
+        [](auto && a, auto && b, auto && c) {
+            return yap::make_expression<yap::expr_kind::call>(
+                term<fma_t>{},
+                std::forward<decltype(a)>(a),
+                std::forward<decltype(b)>(b),
+                std::forward<decltype(c)>(c)
+            );
+        }
+    );
+
+    auto result = yap::rewrite(a * x + y, fuse);
+    EXPECT_TRUE(decltype(result)::kind == yap::expr_kind::call);
+    EXPECT_EQ(yap::evaluate(result), 10.0);
+
+    auto nested = yap::rewrite(a * x + (a * y + x), fuse);
+    EXPECT_TRUE(decltype(nested)::kind == yap::expr_kind::call);
+    EXPECT_EQ(yap::evaluate(nested), 17.0);
+}
+
+TEST(rewrite, test_rvalue_operands)
+{
+    using namespace yap::literals;
+
+    auto const plus_to_minus = yap::rule(1_p + 2_p, 1_p - 2_p);
+
+    auto result = yap::rewrite(term<double>{1.0} + term<double>{3.0}, plus_to_minus);
+    EXPECT_TRUE((std::is_same<
+        decltype(result),
+        yap::expression<yap::expr_kind::minus, bh::tuple<term<double>, term<double>>>
+    >::value));
+    EXPECT_EQ(yap::evaluate(result), -2.0);
+}
+
+TEST(rewrite, test_user_expr)
+{
+    using namespace yap::literals;
+
+    user_term<double> x{bh::make_tuple(2.0)};
+    user_term<double> y{bh::make_tuple(3.0)};
+
+    auto const plus_to_minus = yap::rule(1_p + 2_p, 1_p - 2_p);
+
+    // New nodes are made from the expression template of the node they
+    // replace.
+    auto result = yap::rewrite(x + y, plus_to_minus);
+    EXPECT_TRUE(decltype(result)::kind == yap::expr_kind::minus);
+    EXPECT_TRUE((std::is_same<
+        std::remove_cv_t<std::remove_reference_t<decltype(yap::left(result))>>,
+        boost::yap::expression_ref<user_expr, user_term<double> &>
+    >::value));
+    EXPECT_EQ(yap::evaluate(result), -1.0);
+}
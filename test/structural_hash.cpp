@@ -0,0 +1,194 @@
+#include <boost/yap/expression.hpp>
+#include <boost/yap/hash.hpp>
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <unordered_map>
+
+
+template <typename T>
+using term = boost::yap::terminal<boost::yap::expression, T>;
+
+namespace yap = boost::yap;
+namespace bh = boost::hana;
+
+
+template <boost::yap::expr_kind Kind, typename Tuple>
+struct user_expr
+{
+    static boost::yap::expr_kind const kind = Kind;
+
+    Tuple elements;
+
+    BOOST_YAP_USER_BINARY_OPERATOR_MEMBER(plus, ::user_expr)
+};
+
+template <typename T>
+using user_term = boost::yap::terminal<user_expr, T>;
+
+struct tag {};
+
+
+TEST(structural_hash, test_terminal_values)
+{
+    term<double> a{1.0};
+    term<double> b{1.0};
+    term<double> c{2.0};
+    term<int> i{1};
+
+    EXPECT_EQ(yap::structural_hash(a), yap::structural_hash(b));
+    EXPECT_TRUE(yap::structurally_equal(a, b));
+
+    EXPECT_NE(yap::structural_hash(a), yap::structural_hash(c));
+    EXPECT_FALSE(yap::structurally_equal(a, c));
+
+    // Same value, different terminal types.
+    EXPECT_NE(yap::structural_hash(a), yap::structural_hash(i));
+    EXPECT_FALSE(yap::structurally_equal(a, i));
+
+    term<tag> t1{tag{}};
+    term<tag> t2{tag{}};
+    EXPECT_EQ(yap::structural_hash(t1), yap::structural_hash(t2));
+    EXPECT_TRUE(yap::structurally_equal(t1, t2));
+
+    term<std::string> s1{std::string("foo")};
+    term<std::string> s2{std::string("foo")};
+    term<std::string> s3{std::string("bar")};
+    EXPECT_EQ(yap::structural_hash(s1), yap::structural_hash(s2));
+    EXPECT_TRUE(yap::structurally_equal(s1, s2));
+    EXPECT_FALSE(yap::structurally_equal(s1, s3));
+}
+
+TEST(structural_hash, test_reference_terminals)
+{
+    double x = 1.0;
+    double y = 1.0;
+
+    term<double &> rx_1{x};
+    term<double &> rx_2{x};
+    term<double &> ry{y};
+    term<double> vx{1.0};
+
+    EXPECT_EQ(yap::structural_hash(rx_1), yap::structural_hash(rx_2));
+    EXPECT_TRUE(yap::structurally_equal(rx_1, rx_2));
+
+    // Referent identity, not referent value, is what counts.
+    EXPECT_FALSE(yap::structurally_equal(rx_1, ry));
+    EXPECT_NE(yap::structural_hash(rx_1), yap::structural_hash(ry));
+
+    // A reference to a double is not the same shape as a double.
+    EXPECT_FALSE(yap::structurally_equal(rx_1, vx));
+
+    // But mutating the referent does not change the hash.
+    auto const hash_before = yap::structural_hash(rx_1);
+    x = 42.0;
+    EXPECT_EQ(yap::structural_hash(rx_1), hash_before);
+}
+
+TEST(structural_hash, test_nonterminals)
+{
+    term<double> a{1.0};
+    term<double> b{2.0};
+
+    auto plus_1 = a + b;
+    auto plus_2 = a + b;
+    auto plus_3 = b + a;
+    auto minus = a - b;
+
+    EXPECT_EQ(yap::structural_hash(plus_1), yap::structural_hash(plus_2));
+    EXPECT_TRUE(yap::structurally_equal(plus_1, plus_2));
+
+    EXPECT_FALSE(yap::structurally_equal(plus_1, plus_3));
+    EXPECT_NE(yap::structural_hash(plus_1), yap::structural_hash(plus_3));
+
+    EXPECT_FALSE(yap::structurally_equal(plus_1, minus));
+    EXPECT_NE(yap::structural_hash(plus_1), yap::structural_hash(minus));
+
+    // Different arities.
+    EXPECT_FALSE(yap::structurally_equal(plus_1, a));
+    EXPECT_FALSE(yap::structurally_equal(-a, a + b));
+
+    // Reference expressions are transparent.
+    auto by_ref = plus_1 * a;
+    auto by_value = (a + b) * a;
+    EXPECT_EQ(yap::structural_hash(by_ref), yap::structural_hash(by_value));
+    EXPECT_TRUE(yap::structurally_equal(by_ref, by_value));
+
+    term<double> c{1.0};
+    EXPECT_TRUE(yap::structurally_equal(plus_1 * a, (a + b) * c));
+    term<double> d{3.0};
+    EXPECT_FALSE(yap::structurally_equal(plus_1 * a, (a + d) * c));
+}
+
+TEST(structural_hash, test_placeholders_and_calls)
+{
+    using namespace yap::literals;
+
+    auto expr_1 = 1_p + 2_p;
+    auto expr_2 = 1_p + 2_p;
+    auto expr_3 = 2_p + 1_p;
+
+    EXPECT_EQ(yap::structural_hash(expr_1), yap::structural_hash(expr_2));
+    EXPECT_TRUE(yap::structurally_equal(expr_1, expr_2));
+    EXPECT_FALSE(yap::structurally_equal(expr_1, expr_3));
+
+    term<tag> f{tag{}};
+    auto call_1 = f(1, 2.0);
+    auto call_2 = f(1, 2.0);
+    auto call_3 = f(1, 3.0);
+    auto call_4 = f(1);
+
+    EXPECT_EQ(yap::structural_hash(call_1), yap::structural_hash(call_2));
+    EXPECT_TRUE(yap::structurally_equal(call_1, call_2));
+    EXPECT_FALSE(yap::structurally_equal(call_1, call_3));
+    EXPECT_FALSE(yap::structurally_equal(call_1, call_4));
+}
+
+TEST(structural_hash, test_user_expr)
+{
+    user_term<double> a{bh::make_tuple(1.0)};
+    user_term<double> b{bh::make_tuple(2.0)};
+    term<double> yap_a{1.0};
+    term<double> yap_b{2.0};
+
+    auto user_plus = a + b;
+    auto yap_plus = yap_a + yap_b;
+
+    // Shape and values are all that matter, not the expression template.
+    EXPECT_EQ(yap::structural_hash(user_plus), yap::structural_hash(yap_plus));
+    EXPECT_TRUE(yap::structurally_equal(user_plus, yap_plus));
+}
+
+TEST(structural_hash, test_memo_table)
+{
+    using expr_type = yap::expression<
+        yap::expr_kind::plus,
+        bh::tuple<term<int>, term<int>>
+    >;
+
+    struct hasher
+    {
+        std::size_t operator() (expr_type const & expr) const
+        { return yap::structural_hash(expr); }
+    };
+
+    struct equal
+    {
+        bool operator() (expr_type const & lhs, expr_type const & rhs) const
+        { return yap::structurally_equal(lhs, rhs); }
+    };
+
+    std::unordered_map<expr_type, int, hasher, equal> memo;
+    for (int i = 0; i < 10; ++i) {
+        for (int j = 0; j < 10; ++j) {
+            expr_type expr = term<int>{i} + term<int>{j};
+            memo.emplace(std::move(expr), i + j);
+        }
+    }
+    EXPECT_EQ(memo.size(), 100u);
+
+    auto it = memo.find(term<int>{3} + term<int>{4});
+    ASSERT_NE(it, memo.end());
+    EXPECT_EQ(it->second, 7);
+}
@@ -0,0 +1,173 @@
+#include <boost/yap/yap.hpp>
+#include <boost/yap/workspace.hpp>
+
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+
+int allocations = 0;
+
+void * operator new (std::size_t size)
+{
+    ++allocations;
+    return malloc(size);
+}
+
+void operator delete (void * ptr) noexcept
+{ free(ptr); }
+
+
+namespace yap = boost::yap;
+
+
+struct take_nth
+{
+    template <typename T>
+    auto operator() (yap::terminal_tag, std::vector<T> const & vec)
+    { return yap::make_terminal(vec[n]); }
+
+    std::size_t n;
+};
+
+template <typename T>
+struct is_vector : std::false_type {};
+
+template <typename T, typename A>
+struct is_vector<std::vector<T, A>> : std::true_type {};
+
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(multiplies, yap::expression, is_vector); // *
+BOOST_YAP_USER_UDT_ANY_BINARY_OPERATOR(plus, yap::expression, is_vector); // +
+
+// Assigns expr to vec through a temporary, so that vec may appear in expr.
+template <typename T, typename Expr>
+std::vector<T> & aliasing_assign (std::vector<T> & vec, Expr const & expr)
+{
+    yap::workspace_buffer<T> tmp = yap::current_workspace().acquire<T>(vec.size());
+    for (std::size_t i = 0; i < vec.size(); ++i) {
+        tmp[i] = yap::evaluate(yap::transform(expr, take_nth{i}));
+    }
+    std::copy(tmp.begin(), tmp.end(), vec.begin());
+    return vec;
+}
+
+
+TEST(workspace, test_acquire_release)
+{
+    yap::workspace ws;
+    std::size_t const alignment = yap::workspace::alignment;
+
+    double * first = nullptr;
+    {
+        yap::workspace_buffer<double> buf = ws.acquire<double>(100);
+        EXPECT_EQ(buf.size(), 100u);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(buf.data()) % alignment, 0u);
+        first = buf.data();
+        for (std::size_t i = 0; i < buf.size(); ++i) {
+            buf[i] = double(i);
+        }
+        EXPECT_EQ(buf[99], 99.0);
+    }
+    EXPECT_EQ(ws.allocations(), 1u);
+
+    {
+        // 120 doubles is in the same size class as 100.
+        yap::workspace_buffer<double> buf = ws.acquire<double>(120);
+        EXPECT_EQ(buf.data(), first);
+
+        // Both buffers are in use, so this one is new.
+        yap::workspace_buffer<double> other = ws.acquire<double>(100);
+        EXPECT_NE(other.data(), first);
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(other.data()) % alignment, 0u);
+    }
+    EXPECT_EQ(ws.allocations(), 2u);
+
+    {
+        yap::workspace_buffer<char> small = ws.acquire<char>(3);
+        EXPECT_EQ(ws.allocations(), 3u);
+        yap::workspace_buffer<double> none = ws.acquire<double>(0);
+        EXPECT_TRUE(none.empty());
+        EXPECT_EQ(none.data(), nullptr);
+    }
+    EXPECT_EQ(ws.allocations(), 3u);
+}
+
+TEST(workspace, test_too_large)
+{
+    yap::workspace ws;
+
+    // n * sizeof(T) overflows.
+    EXPECT_THROW(ws.acquire<double>(std::size_t(-1) / 2), std::bad_alloc);
+    // n * sizeof(T) fits, but is larger than the largest size class.
+    EXPECT_THROW(ws.acquire<char>(std::size_t(-1) / 2 + 2), std::bad_alloc);
+    EXPECT_EQ(ws.allocations(), 0u);
+}
+
+TEST(workspace, test_move)
+{
+    yap::workspace ws;
+
+    yap::workspace_buffer<int> a = ws.acquire<int>(10);
+    int * const data = a.data();
+    yap::workspace_buffer<int> b = std::move(a);
+    EXPECT_TRUE(a.empty());
+    EXPECT_EQ(b.data(), data);
+
+    yap::workspace_buffer<int> c;
+    c = std::move(b);
+    EXPECT_TRUE(b.empty());
+    EXPECT_EQ(c.data(), data);
+
+    c.release();
+    EXPECT_TRUE(c.empty());
+    EXPECT_EQ(ws.acquire<int>(10).data(), data);
+    EXPECT_EQ(ws.allocations(), 1u);
+}
+
+TEST(workspace, test_scope)
+{
+    yap::workspace & thread_default = yap::current_workspace();
+    EXPECT_EQ(&yap::current_workspace(), &thread_default);
+
+    yap::workspace outer;
+    {
+        yap::workspace_scope outer_scope(outer);
+        EXPECT_EQ(&yap::current_workspace(), &outer);
+        {
+            yap::workspace inner;
+            yap::workspace_scope inner_scope(inner);
+            EXPECT_EQ(&yap::current_workspace(), &inner);
+        }
+        EXPECT_EQ(&yap::current_workspace(), &outer);
+    }
+    EXPECT_EQ(&yap::current_workspace(), &thread_default);
+}
+
+TEST(workspace, test_steady_state_allocations)
+{
+    std::size_t const n = 1000;
+    std::vector<double> a(n, 1.0);
+    std::vector<double> b(n, 2.0);
+
+    yap::workspace ws;
+    yap::workspace_scope scope(ws);
+
+    // The first round fills the workspace.
+    aliasing_assign(a, a * b + a);
+    EXPECT_EQ(a[0], 3.0);
+    EXPECT_EQ(ws.allocations(), 1u);
+
+    allocations = 0;
+    for (int i = 0; i < 10; ++i) {
+        aliasing_assign(a, a * b + b);
+    }
+    EXPECT_EQ(allocations, 0);
+    EXPECT_EQ(ws.allocations(), 1u);
+
+    ws.trim();
+    aliasing_assign(a, a + b);
+    EXPECT_EQ(allocations, 1);
+    EXPECT_EQ(ws.allocations(), 2u);
+}